@@ -552,6 +552,11 @@ struct EnableTracerModel<TypeTag, TTag::EclBaseProblem> {
     static constexpr bool value = false;
 };
 
+template<class TypeTag>
+struct EnableTracerUpwindSweep<TypeTag, TTag::EclBaseProblem> {
+    static constexpr bool value = false;
+};
+
 // By default, simulators derived from the EclBaseProblem are production simulators,
 // i.e., experimental features must be explicitly enabled at compile time
 template<class TypeTag>
@@ -697,6 +702,8 @@ public:
                              "The frequencies of which time steps are serialized to disk");
         EWOMS_REGISTER_PARAM(TypeTag, bool, EnableTracerModel,
                              "Transport tracers found in the deck.");
+        EWOMS_REGISTER_PARAM(TypeTag, bool, EnableTracerUpwindSweep,
+                             "Solve the tracer transport by a sweep over the cells in upwind order instead of an iterative linear solver.");
         EWOMS_REGISTER_PARAM(TypeTag, bool, EclEnableDriftCompensation,
                              "Enable partial compensation of systematic mass losses via the source term of the next time step");
         if (enableExperiments)
@@ -30,6 +30,8 @@
 
 #include <opm/parser/eclipse/EclipseState/Tables/TracerVdTable.hpp>
 
+#include "ecltracerupwindsolver.hh"
+
 #include <opm/models/blackoil/blackoilmodel.hh>
 #include <opm/common/OpmLog/OpmLog.hpp>
 
@@ -39,7 +41,11 @@
 
 #include <dune/common/version.hh>
 
+#include <algorithm>
+#include <array>
+#include <cmath>
 #include <string>
+#include <utility>
 #include <vector>
 #include <iostream>
 
@@ -50,6 +56,11 @@ struct EnableTracerModel {
     using type = UndefinedProperty;
 };
 
+template<class TypeTag, class MyTypeTag>
+struct EnableTracerUpwindSweep {
+    using type = UndefinedProperty;
+};
+
 } // namespace Opm::Properties
 
 namespace Opm {
@@ -87,10 +98,12 @@ class EclTracerModel
 
     typedef Dune::BCRSMatrix<Dune::FieldMatrix<Scalar, 1, 1>> TracerMatrix;
     typedef Dune::BlockVector<Dune::FieldVector<Scalar,1>> TracerVector;
+    typedef EclTracerUpwindSolver<Scalar> UpwindSolver;
 
 public:
     EclTracerModel(Simulator& simulator)
         : simulator_(simulator)
+        , useUpwindSweep_(false)
     { }
 
 
@@ -175,6 +188,8 @@ public:
         // initial tracer concentration
         tracerConcentrationInitial_ = tracerConcentration_;
 
+        useUpwindSweep_ = EWOMS_GET_PARAM(TypeTag, bool, EnableTracerUpwindSweep);
+
         // residual of tracers
         tracerResidual_.resize(numGridDof);
 
@@ -285,6 +300,22 @@ public:
         if (numTracers()==0)
             return;
 
+        if (useUpwindSweep_) {
+            // the upwind operator only depends on the phase which carries the
+            // tracer, so it is assembled and ordered once per phase.
+            std::array<bool, numPhases> phaseAssembled;
+            phaseAssembled.fill(false);
+            for (int tracerIdx = 0; tracerIdx < numTracers(); ++ tracerIdx){
+                const int phaseIdx = tracerPhaseIdx_[tracerIdx];
+                if (!phaseAssembled[phaseIdx]) {
+                    assembleUpwindSystem_(tracerIdx);
+                    phaseAssembled[phaseIdx] = true;
+                }
+                sweepSolve_(tracerIdx);
+            }
+            return;
+        }
+
         for (int tracerIdx = 0; tracerIdx < numTracers(); ++ tracerIdx){
 
             TracerVector dx(tracerResidual_.size());
@@ -492,6 +523,119 @@ protected:
         }
     }
 
+    // assemble the upwind operator for the phase of a tracer from the fluxes
+    // of the last pressure solution. the accumulation term is taken from the
+    // storage of the tracer, i.e., the operator can be used for all tracers
+    // which are carried by the same phase.
+    void assembleUpwindSystem_(int tracerIdx)
+    {
+        const int phaseIdx = tracerPhaseIdx_[tracerIdx];
+        const size_t numGridDof = simulator_.model().numGridDof();
+        const Scalar dt = simulator_.timeStepSize();
+
+        std::vector<Scalar> diag(numGridDof, 0.0);
+        volumeOverDt_.assign(numGridDof, 0.0);
+        typename UpwindSolver::UpstreamList upstream(numGridDof);
+
+        ElementContext elemCtx(simulator_);
+        auto elemIt = simulator_.gridView().template begin</*codim=*/0>();
+        auto elemEndIt = simulator_.gridView().template end</*codim=*/0>();
+        for (; elemIt != elemEndIt; ++ elemIt) {
+            elemCtx.updateAll(*elemIt);
+
+            const unsigned I = elemCtx.globalSpaceIndex(/*dofIdx=*/ 0, /*timIdx=*/0);
+            const Scalar extrusionFactor =
+                elemCtx.intensiveQuantities(/*dofIdx=*/ 0, /*timeIdx=*/0).extrusionFactor();
+            const Scalar scvVolume =
+                elemCtx.stencil(/*timeIdx=*/0).subControlVolume(/*dofIdx=*/ 0).volume()
+                * extrusionFactor;
+
+            // the storage is linear in the concentration, its derivative is
+            // the phase volume per bulk volume.
+            TracerEvaluation storage;
+            computeStorage_(storage, elemCtx, 0, /*timeIdx=*/0, tracerIdx);
+            volumeOverDt_[I] = scvVolume/dt;
+            diag[I] = storage.derivative(0) * volumeOverDt_[I];
+
+            // without the storage cache the storage of the last time step is
+            // evaluated from the old intensive quantities.
+            if (!elemCtx.enableStorageCache()) {
+                for (int otherIdx = 0; otherIdx < numTracers(); ++ otherIdx) {
+                    if (tracerPhaseIdx_[otherIdx] != phaseIdx)
+                        continue;
+                    Scalar storageOfTimeIndex1;
+                    computeStorage_(storageOfTimeIndex1, elemCtx, 0, /*timeIdx=*/1, otherIdx);
+                    storageOfTimeIndex1_[otherIdx][I] = storageOfTimeIndex1;
+                }
+            }
+
+            const size_t numInteriorFaces = elemCtx.numInteriorFaces(/*timIdx=*/0);
+            for (unsigned scvfIdx = 0; scvfIdx < numInteriorFaces; scvfIdx++) {
+                const auto& face = elemCtx.stencil(0).interiorFace(scvfIdx);
+                const auto& extQuants = elemCtx.extensiveQuantities(scvfIdx, /*timeIdx=*/0);
+                const unsigned upIdx = extQuants.upstreamIndex(phaseIdx);
+                const auto& fs = elemCtx.intensiveQuantities(upIdx, /*timeIdx=*/0).fluidState();
+
+                const Scalar coeff =
+                    face.area()
+                    * Opm::decay<Scalar>(extQuants.volumeFlux(phaseIdx))
+                    * Opm::decay<Scalar>(fs.invB(phaseIdx));
+
+                if (upIdx == extQuants.interiorIndex())
+                    diag[I] += coeff;
+                else if (coeff != 0.0)
+                    upstream[I].emplace_back(elemCtx.globalSpaceIndex(upIdx, /*timeIdx=*/0), coeff);
+            }
+        }
+
+        upwindSolver_[phaseIdx].assemble(std::move(diag), upstream);
+    }
+
+    // solve the tracer transport for one tracer by a single sweep over the
+    // cells in upwind order.
+    void sweepSolve_(int tracerIdx)
+    {
+        const int phaseIdx = tracerPhaseIdx_[tracerIdx];
+        auto& solver = upwindSolver_[phaseIdx];
+        const size_t numGridDof = solver.diagonal().size();
+
+        // right hand side: accumulation of the last time step plus the wells
+        std::vector<Scalar> diag(solver.diagonal());
+        std::vector<Scalar> rhs(numGridDof);
+        for (unsigned I = 0; I < numGridDof; ++I)
+            rhs[I] = storageOfTimeIndex1_[tracerIdx][I][0] * volumeOverDt_[I];
+
+        const int episodeIdx = simulator_.episodeIndex();
+        const auto& wells = simulator_.vanguard().schedule().getWells(episodeIdx);
+        for (const auto& well : wells) {
+            if (well.getStatus() == Opm::Well::Status::SHUT)
+                continue;
+
+            const double wtracer = well.getTracerProperties().getConcentration(tracerNames_[tracerIdx]);
+            std::array<int, 3> cartesianCoordinate;
+            for (auto& connection : well.getConnections()) {
+                if (connection.state() == Opm::Connection::State::SHUT)
+                    continue;
+
+                cartesianCoordinate[0] = connection.getI();
+                cartesianCoordinate[1] = connection.getJ();
+                cartesianCoordinate[2] = connection.getK();
+                const size_t cartIdx = simulator_.vanguard().cartesianIndex(cartesianCoordinate);
+                const int I = cartToGlobal_[cartIdx];
+                Scalar rate = simulator_.problem().wellModel().well(well.name())->volumetricSurfaceRateForConnection(I, phaseIdx);
+                if (rate > 0)
+                    rhs[I] += rate*wtracer;
+                else if (rate < 0)
+                    diag[I] -= rate;
+            }
+        }
+
+        if (!solver.solve(diag, rhs, tracerConcentration_[tracerIdx]))
+            OpmLog::warning("Tracer " + tracerNames_[tracerIdx]
+                            + ": the Gauss-Seidel iterations of the upwind sweep did not converge,"
+                            " the concentrations of the circulating cells may be inaccurate.");
+    }
+
     Simulator& simulator_;
 
     std::vector<std::string> tracerNames_;
@@ -503,6 +647,10 @@ protected:
     std::vector<int> cartToGlobal_;
     std::vector<Dune::BlockVector<Dune::FieldVector<Scalar, 1>>> storageOfTimeIndex1_;
 
+    bool useUpwindSweep_;
+    std::array<UpwindSolver, numPhases> upwindSolver_;
+    std::vector<Scalar> volumeOverDt_;
+
 };
 } // namespace Opm
 
@@ -0,0 +1,294 @@
+// -*- mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*-
+// vi: set et ts=4 sw=4 sts=4:
+/*
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+
+  Consult the COPYING file in the top-level source directory of this
+  module for the precise wording of the license and the list of
+  copyright holders.
+*/
+/**
+ * \file
+ *
+ * \copydoc Opm::EclTracerUpwindSolver
+ */
+#ifndef EWOMS_ECL_TRACER_UPWIND_SOLVER_HH
+#define EWOMS_ECL_TRACER_UPWIND_SOLVER_HH
+
+#include <dune/common/dynmatrix.hh>
+#include <dune/common/dynvector.hh>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <utility>
+#include <vector>
+
+namespace Opm {
+
+/*!
+ * \ingroup EclBlackOilSimulator
+ *
+ * \brief Solver for the upwind transport operator of a single phase.
+ *
+ * Row I of the operator reads
+ *
+ *    diag[I]*c_I + sum_J upCoeff[IJ]*c_J = rhs_I
+ *
+ * where the J are the cells which are upstream of I. The rows are stored in
+ * compressed form and the cells are ordered topologically with respect to
+ * the flux graph, i.e., a cell is always visited after all its upstream
+ * neighbors except for cells within the same strongly connected component.
+ */
+template <class Scalar>
+class EclTracerUpwindSolver
+{
+public:
+    using UpstreamList = std::vector<std::vector<std::pair<unsigned, Scalar>>>;
+
+    explicit EclTracerUpwindSolver(unsigned maxDirectComponentSize = 64,
+                                   int maxGaussSeidelIter = 100,
+                                   Scalar gaussSeidelTolerance = 1e-8)
+        : maxDirectComponentSize_(maxDirectComponentSize)
+        , maxGaussSeidelIter_(maxGaussSeidelIter)
+        , gaussSeidelTolerance_(gaussSeidelTolerance)
+    { }
+
+    /*!
+     * \brief Set up the operator from its diagonal and, for each cell, the
+     *        list of upstream cells and their coupling coefficients, and
+     *        compute the topological ordering of the cells.
+     */
+    void assemble(std::vector<Scalar> diag, const UpstreamList& upstream)
+    {
+        const unsigned numCells = diag.size();
+        diag_ = std::move(diag);
+
+        rowStart_.resize(numCells + 1);
+        upCell_.clear();
+        upCoeff_.clear();
+        rowStart_[0] = 0;
+        for (unsigned I = 0; I < numCells; ++I) {
+            for (const auto& up : upstream[I]) {
+                upCell_.push_back(up.first);
+                upCoeff_.push_back(up.second);
+            }
+            rowStart_[I + 1] = upCell_.size();
+        }
+
+        computeOrdering_();
+    }
+
+    /*!
+     * \brief The diagonal of the operator as passed to assemble().
+     */
+    const std::vector<Scalar>& diagonal() const
+    { return diag_; }
+
+    /*!
+     * \brief The number of strongly connected components of the flux graph.
+     */
+    unsigned numComponents() const
+    { return componentStart_.size() - 1; }
+
+    /*!
+     * \brief Solve the system by a single sweep over the cells in upwind
+     *        order.
+     *
+     * Only the cells of strongly connected components, i.e., cells with
+     * circulating flow, require a local solve. The diagonal may differ from
+     * the assembled one, e.g. because of producing well connections.
+     *
+     * \return false if the Gauss-Seidel iterations of a component did not
+     *         converge within the iteration limit.
+     */
+    template <class Vector>
+    bool solve(const std::vector<Scalar>& diag,
+               const std::vector<Scalar>& rhs,
+               Vector& c)
+    {
+        bool converged = true;
+        for (unsigned compIdx = 0; compIdx < numComponents(); ++compIdx) {
+            const unsigned begin = componentStart_[compIdx];
+            const unsigned end = componentStart_[compIdx + 1];
+
+            if (end - begin == 1) {
+                const unsigned I = order_[begin];
+                c[I] = upwindRhs_(rhs, c, I) / diag[I];
+                continue;
+            }
+
+            converged = solveComponent_(diag, rhs, c, begin, end) && converged;
+        }
+        return converged;
+    }
+
+private:
+    template <class Vector>
+    Scalar upwindRhs_(const std::vector<Scalar>& rhs, const Vector& c, unsigned I) const
+    {
+        Scalar r = rhs[I];
+        for (unsigned e = rowStart_[I]; e < rowStart_[I + 1]; ++e)
+            r -= upCoeff_[e] * c[upCell_[e]][0];
+        return r;
+    }
+
+    // Tarjan's algorithm on the "depends on upstream cell" graph. Strongly
+    // connected components are emitted after all components they depend on,
+    // so the resulting order can directly be used for a forward sweep. The
+    // depth first search is done with an explicit stack to cope with long
+    // flow paths.
+    void computeOrdering_()
+    {
+        const unsigned numCells = diag_.size();
+        const unsigned unvisited = std::numeric_limits<unsigned>::max();
+
+        std::vector<unsigned> index(numCells, unvisited);
+        std::vector<unsigned> lowLink(numCells, 0);
+        std::vector<char> onStack(numCells, 0);
+        std::vector<unsigned> sccStack;
+        std::vector<std::pair<unsigned, unsigned>> dfsStack;
+
+        order_.clear();
+        order_.reserve(numCells);
+        componentStart_.clear();
+
+        unsigned nextIndex = 0;
+        for (unsigned root = 0; root < numCells; ++root) {
+            if (index[root] != unvisited)
+                continue;
+
+            dfsStack.emplace_back(root, rowStart_[root]);
+            index[root] = lowLink[root] = nextIndex++;
+            sccStack.push_back(root);
+            onStack[root] = 1;
+
+            while (!dfsStack.empty()) {
+                auto& [cell, edge] = dfsStack.back();
+                if (edge < rowStart_[cell + 1]) {
+                    const unsigned up = upCell_[edge++];
+                    if (index[up] == unvisited) {
+                        index[up] = lowLink[up] = nextIndex++;
+                        sccStack.push_back(up);
+                        onStack[up] = 1;
+                        dfsStack.emplace_back(up, rowStart_[up]);
+                    }
+                    else if (onStack[up])
+                        lowLink[cell] = std::min(lowLink[cell], index[up]);
+                    continue;
+                }
+
+                const unsigned finished = cell;
+                dfsStack.pop_back();
+                if (!dfsStack.empty()) {
+                    const unsigned parent = dfsStack.back().first;
+                    lowLink[parent] = std::min(lowLink[parent], lowLink[finished]);
+                }
+
+                if (lowLink[finished] == index[finished]) {
+                    componentStart_.push_back(order_.size());
+                    unsigned member;
+                    do {
+                        member = sccStack.back();
+                        sccStack.pop_back();
+                        onStack[member] = 0;
+                        order_.push_back(member);
+                    } while (member != finished);
+                }
+            }
+        }
+        componentStart_.push_back(order_.size());
+    }
+
+    // solve the coupled equations of a strongly connected component. small
+    // components are solved directly, large ones by Gauss-Seidel sweeps in
+    // the order established by the ordering of the component.
+    template <class Vector>
+    bool solveComponent_(const std::vector<Scalar>& diag,
+                         const std::vector<Scalar>& rhs,
+                         Vector& c,
+                         unsigned begin,
+                         unsigned end)
+    {
+        const unsigned size = end - begin;
+        bool converged = true;
+
+        if (size <= maxDirectComponentSize_) {
+            if (localIdx_.size() != diag.size())
+                localIdx_.assign(diag.size(), -1);
+            for (unsigned i = 0; i < size; ++i)
+                localIdx_[order_[begin + i]] = i;
+
+            Dune::DynamicMatrix<Scalar> A(size, size, 0.0);
+            Dune::DynamicVector<Scalar> b(size, 0.0);
+            Dune::DynamicVector<Scalar> x(size, 0.0);
+            for (unsigned i = 0; i < size; ++i) {
+                const unsigned I = order_[begin + i];
+                A[i][i] = diag[I];
+                b[i] = rhs[I];
+                for (unsigned e = rowStart_[I]; e < rowStart_[I + 1]; ++e) {
+                    const unsigned J = upCell_[e];
+                    if (localIdx_[J] >= 0)
+                        A[i][localIdx_[J]] += upCoeff_[e];
+                    else
+                        b[i] -= upCoeff_[e] * c[J][0];
+                }
+            }
+            A.solve(x, b);
+            for (unsigned i = 0; i < size; ++i)
+                c[order_[begin + i]] = x[i];
+
+            for (unsigned i = 0; i < size; ++i)
+                localIdx_[order_[begin + i]] = -1;
+        }
+        else {
+            converged = false;
+            for (int iter = 0; iter < maxGaussSeidelIter_; ++iter) {
+                Scalar maxChange = 0.0;
+                Scalar maxValue = 0.0;
+                for (unsigned i = 0; i < size; ++i) {
+                    const unsigned I = order_[begin + i];
+                    const Scalar cNew = upwindRhs_(rhs, c, I) / diag[I];
+                    maxChange = std::max(maxChange, std::abs(cNew - c[I][0]));
+                    maxValue = std::max(maxValue, std::abs(cNew));
+                    c[I] = cNew;
+                }
+                if (maxChange <= gaussSeidelTolerance_ * std::max(maxValue, Scalar(1.0))) {
+                    converged = true;
+                    break;
+                }
+            }
+        }
+
+        return converged;
+    }
+
+    unsigned maxDirectComponentSize_;
+    int maxGaussSeidelIter_;
+    Scalar gaussSeidelTolerance_;
+
+    std::vector<Scalar> diag_;
+    std::vector<unsigned> rowStart_;
+    std::vector<unsigned> upCell_;
+    std::vector<Scalar> upCoeff_;
+    std::vector<unsigned> order_;
+    std::vector<unsigned> componentStart_;
+    std::vector<int> localIdx_;
+};
+
+} // namespace Opm
+
+#endif
@@ -35,6 +35,7 @@
 #include <opm/simulators/aquifers/BlackoilAquiferModel.hpp>
 #include <opm/simulators/wells/WellConnectionAuxiliaryModule.hpp>
 #include <opm/simulators/flow/countGlobalCells.hpp>
+#include <opm/simulators/flow/partitionCells.hpp>
 
 #include <opm/grid/UnstructuredGrid.h>
 #include <opm/simulators/timestepping/SimulatorReport.hpp>
@@ -50,8 +51,14 @@
 #include <opm/parser/eclipse/EclipseState/Tables/TableManager.hpp>
 
 #include <opm/simulators/linalg/ISTLSolverEbos.hpp>
+#include <opm/simulators/linalg/FlexibleSolver.hpp>
+#include <opm/simulators/linalg/getQuasiImpesWeights.hpp>
+#include <opm/simulators/linalg/setupPropertyTree.hpp>
 
+#include <dune/istl/operators.hh>
 #include <dune/istl/owneroverlapcopy.hh>
+#include <dune/istl/preconditioners.hh>
+#include <dune/istl/solvers.hh>
 #if DUNE_VERSION_NEWER(DUNE_COMMON, 2, 7)
 #include <dune/common/parallel/communication.hh>
 #else
@@ -62,9 +69,13 @@
 
 #include <cassert>
 #include <cmath>
+#include <deque>
+#include <exception>
 #include <iostream>
 #include <iomanip>
+#include <sstream>
 #include <limits>
+#include <tuple>
 #include <vector>
 #include <algorithm>
 
@@ -154,6 +165,8 @@ namespace Opm {
 
         using Simulator = GetPropType<TypeTag, Properties::Simulator>;
         using Grid = GetPropType<TypeTag, Properties::Grid>;
+        using GridView = GetPropType<TypeTag, Properties::GridView>;
+        using ThreadManager = GetPropType<TypeTag, Properties::ThreadManager>;
         using ElementContext = GetPropType<TypeTag, Properties::ElementContext>;
         using SparseMatrixAdapter = GetPropType<TypeTag, Properties::SparseMatrixAdapter>;
         using SolutionVector = GetPropType<TypeTag, Properties::SolutionVector>;
@@ -186,6 +199,9 @@ namespace Opm {
         typedef Dune::BlockVector<VectorBlockType>      BVector;
 
         typedef ISTLSolverEbos<TypeTag> ISTLSolverType;
+        typedef Dune::BCRSMatrix<Dune::FieldMatrix<Scalar, 1, 1>> PressureMatrix;
+        typedef Dune::BlockVector<Dune::FieldVector<Scalar, 1>> PressureVector;
+        typedef typename GridView::template Codim<0>::Entity Element;
         //typedef typename SolutionVector :: value_type            PrimaryVariables ;
 
         // ---------  Public methods  ---------
@@ -211,11 +227,52 @@ namespace Opm {
         , well_model_ (well_model)
         , terminal_output_ (terminal_output)
         , current_relaxation_(1.0)
+        , linear_reduction_(param_.adaptive_linear_tolerance_max_)
+        , line_search_step_(1.0)
+        , line_search_backtracks_(0)
+        , chordJacobianValid_(false)
         , dx_old_(UgGridHelpers::numCells(grid_))
+        , skippedCellsLastUpdate_(0)
         {
             // compute global sum of number of cells
             global_nc_ = detail::countGlobalCells(grid_);
+
+            const auto& elemMapper = ebosSimulator_.model().elementMapper();
+            for (const auto& elem : elements(ebosSimulator_.gridView(), Dune::Partitions::interior)) {
+                interiorCells_.push_back(elemMapper.index(elem));
+            }
             convergence_reports_.reserve(300); // Often insufficient, but avoids frequent moves.
+
+            if (param_.nonlinear_solver_ == "nldd" && isParallel()) {
+                if (terminal_output_) {
+                    OpmLog::warning("The NLDD nonlinear solver is only supported for serial runs, "
+                                    "using the standard Newton method instead.");
+                }
+            }
+            // The localized re-evaluation keeps the cached intensive quantities
+            // of the unchanged cells, so it needs the cache.
+            localizedReevaluation_ = param_.use_localized_reevaluation_
+                && EWOMS_GET_PARAM(TypeTag, bool, EnableIntensiveQuantityCache);
+            if (param_.use_localized_reevaluation_ && !localizedReevaluation_) {
+                if (terminal_output_) {
+                    OpmLog::warning("Localized re-evaluation requires the intensive quantity cache, "
+                                    "re-evaluating all cells after each update instead.");
+                }
+            }
+            if (param_.nonlinear_solver_ == "sequential") {
+                if (isParallel()) {
+                    if (terminal_output_) {
+                        OpmLog::warning("The sequential nonlinear solver is only supported for serial runs, "
+                                        "using the standard Newton method instead.");
+                    }
+                }
+                else {
+                    FlowLinearSolverParameters linearSolverParam;
+                    linearSolverParam.template init<TypeTag>();
+                    pressureSolverPrm_ = setupAMG("amg", linearSolverParam);
+                    transportSolverPrm_ = setupILU("ilu0", linearSolverParam);
+                }
+            }
         }
 
         bool isParallel() const
@@ -246,8 +303,23 @@ namespace Opm {
             ebosSimulator_.setTimeStepSize(timer.currentStepLength());
             ebosSimulator_.model().newtonMethod().setIterationIndex(0);
 
+            std::vector<double> predictorCoefficients;
+            if (param_.solution_predictor_order_ > 0) {
+                predictorCoefficients = predictorCoefficients_(timer.simulationTimeElapsed(),
+                                                               timer.simulationTimeElapsed() + timer.currentStepLength());
+                predictSolution_(predictorCoefficients);
+            }
+
             ebosSimulator_.problem().beginTimeStep();
 
+            if (!predictorCoefficients.empty()) {
+                std::vector<const WellState*> wellStates;
+                for (const auto& wellState : predictorWellStates_) {
+                    wellStates.push_back(&wellState);
+                }
+                wellModel().predictWellState(wellStates, predictorCoefficients);
+            }
+
             unsigned numDof = ebosSimulator_.model().numGridDof();
             wasSwitched_.resize(numDof);
             std::fill(wasSwitched_.begin(), wasSwitched_.end(), false);
@@ -285,49 +357,113 @@ namespace Opm {
                 // For each iteration we store in a vector the norms of the residual of
                 // the mass balance for each active phase, the well flux and the well equations.
                 residual_norms_history_.clear();
+                line_search_norms_.clear();
                 current_relaxation_ = 1.0;
+                linear_reduction_ = param_.adaptive_linear_tolerance_max_;
+                line_search_step_ = 1.0;
+                line_search_backtracks_ = 0;
+                chordJacobianValid_ = false;
                 dx_old_ = 0.0;
+                skippedCellsLastUpdate_ = 0;
+                resetEvaluatedSolution_();
                 convergence_reports_.push_back({timer.reportStepNum(), timer.currentStepNum(), {}});
                 convergence_reports_.back().report.reserve(11);
             }
 
             report.total_linearizations = 1;
 
-            try {
-                report += assembleReservoir(timer, iteration);
-                report.assemble_time += perfTimer.stop();
-            }
-            catch (...) {
-                report.assemble_time += perfTimer.stop();
-                failureReport_ += report;
-                // todo (?): make the report an attribute of the class
-                throw; // continue throwing the stick
+            // The NLDD solver first solves the subdomain problems with the
+            // coupling to the rest of the grid frozen, and then does a global
+            // Newton iteration for the coupling. The well model is only fully
+            // set up by the first global iteration of a time step.
+            if (useNldd_() && iteration > 0) {
+                try {
+                    solveLocalDomains_(report);
+                    report.local_solve_time += perfTimer.stop();
+                }
+                catch (...) {
+                    report.local_solve_time += perfTimer.stop();
+                    failureReport_ += report;
+                    throw;
+                }
+                perfTimer.reset();
+                perfTimer.start();
             }
 
             std::vector<double> residual_norms;
-            perfTimer.reset();
-            perfTimer.start();
-            // the step is not considered converged until at least minIter iterations is done
-            {
-                auto convrep = getConvergence(timer, iteration,residual_norms);
-                report.converged = convrep.converged()  && iteration > nonlinear_solver.minIter();;
-                ConvergenceReport::Severity severity = convrep.severityOfWorstFailure();
-                convergence_reports_.back().report.push_back(std::move(convrep));
+            while (true) {
+                try {
+                    report += assembleReservoir(timer, iteration);
+                    report.assemble_time += perfTimer.stop();
+                }
+                catch (...) {
+                    report.assemble_time += perfTimer.stop();
+                    failureReport_ += report;
+                    // todo (?): make the report an attribute of the class
+                    throw; // continue throwing the stick
+                }
 
-                // Throw if any NaN or too large residual found.
-                if (severity == ConvergenceReport::Severity::NotANumber) {
-                    OPM_THROW(Opm::NumericalIssue, "NaN residual found!");
-                } else if (severity == ConvergenceReport::Severity::TooLarge) {
-                    OPM_THROW(Opm::NumericalIssue, "Too large residual found!");
+                residual_norms.clear();
+                perfTimer.reset();
+                perfTimer.start();
+                // the step is not considered converged until at least minIter iterations is done
+                {
+                    auto convrep = getConvergence(timer, iteration,residual_norms);
+                    report.converged = convrep.converged()  && iteration > nonlinear_solver.minIter();;
+                    ConvergenceReport::Severity severity = convrep.severityOfWorstFailure();
+                    convergence_reports_.back().report.push_back(std::move(convrep));
+
+                    // Throw if any NaN or too large residual found.
+                    if (severity == ConvergenceReport::Severity::NotANumber) {
+                        OPM_THROW(Opm::NumericalIssue, "NaN residual found!");
+                    } else if (severity == ConvergenceReport::Severity::TooLarge) {
+                        OPM_THROW(Opm::NumericalIssue, "Too large residual found!");
+                    }
                 }
+
+                // With localized re-evaluation the residual of cells whose
+                // update was below the tolerance is evaluated with their
+                // previous intensive quantities. Convergence is only accepted
+                // for a residual evaluated with all of them up to date.
+                if (!report.converged || countStaleCells_() == 0) {
+                    break;
+                }
+                convergence_reports_.back().report.pop_back();
+                ebosSimulator_.model().invalidateAndUpdateIntensiveQuantities(/*timeIdx=*/0);
+                resetEvaluatedSolution_();
+                report.total_linearizations += 1;
+                report.update_time += perfTimer.stop();
+                perfTimer.reset();
+                perfTimer.start();
             }
             report.update_time += perfTimer.stop();
             residual_norms_history_.push_back(residual_norms);
+            if (nonlinear_solver.accelerationType() == NonlinearSolverType::LineSearch) {
+                line_search_norms_.push_back(lineSearchNorm_(residual_norms));
+            }
+
+            if (!report.converged
+                && nonlinear_solver.accelerationType() == NonlinearSolverType::LineSearch
+                && backtrackLastUpdate_(nonlinear_solver.lineSearchMaxBacktracks())) {
+                return report;
+            }
+
             if (!report.converged) {
                 perfTimer.reset();
                 perfTimer.start();
                 report.total_newton_iterations = 1;
 
+                if (useSequential_()) {
+                    try {
+                        solveSequential_(timer, iteration, report);
+                    }
+                    catch (...) {
+                        failureReport_ += report;
+                        throw;
+                    }
+                    return report;
+                }
+
                 // enable single precision for solvers when dt is smaller then 20 days
                 //residual_.singlePrecision = (unit::convert::to(dt, unit::day) < 20.) ;
 
@@ -343,7 +479,12 @@ namespace Opm {
                 // Solve the linear system.
                 linear_solve_setup_time_ = 0.0;
                 try {
-                    solveJacobianSystem(x);
+                    if (useChordIteration_()) {
+                        solveChordSystem_(x);
+                    }
+                    else {
+                        solveJacobianSystem(x);
+                    }
                     report.linear_solve_setup_time += linear_solve_setup_time_;
                     report.linear_solve_time += perfTimer.stop();
                     report.total_linear_iterations += linearIterationsLastSolve();
@@ -363,6 +504,9 @@ namespace Opm {
                 // handling well state update before oscillation treatment is a decision based
                 // on observation to avoid some big performance degeneration under some circumstances.
                 // there is no theorectical explanation which way is better for sure.
+                if (nonlinear_solver.accelerationType() == NonlinearSolverType::LineSearch) {
+                    lineSearchWellState_ = wellModel().wellState();
+                }
                 wellModel().postSolve(x);
 
                 if (param_.use_update_stabilization_) {
@@ -382,10 +526,23 @@ namespace Opm {
                     nonlinear_solver.stabilizeNonlinearUpdate(x, dx_old_, current_relaxation_);
                 }
 
+                if (nonlinear_solver.accelerationType() == NonlinearSolverType::Anderson) {
+                    nonlinear_solver.andersonAccelerate(x, interiorCells_, grid_.comm());
+                    andersonSolution_ = ebosSimulator_.model().solution(/*timeIdx=*/0);
+                }
+                else if (nonlinear_solver.accelerationType() == NonlinearSolverType::LineSearch) {
+                    lineSearchSolution_ = ebosSimulator_.model().solution(/*timeIdx=*/0);
+                    lineSearchUpdate_ = x;
+                }
+
                 // Apply the update, with considering model-dependent limitations and
                 // chopping of the update.
                 updateSolution(x);
 
+                if (nonlinear_solver.accelerationType() == NonlinearSolverType::Anderson) {
+                    nonlinear_solver.setAppliedUpdate(appliedUpdate_(andersonSolution_, x));
+                }
+
                 report.update_time += perfTimer.stop();
             }
 
@@ -408,6 +565,11 @@ namespace Opm {
             Dune::Timer perfTimer;
             perfTimer.start();
             ebosSimulator_.problem().endTimeStep();
+            // the operability checks at the end of the time step
+            wellModel().addOperabilityCacheStatistics(report);
+            if (param_.solution_predictor_order_ > 0) {
+                storeConvergedState_();
+            }
             report.pre_post_time += perfTimer.stop();
             return report;
         }
@@ -541,7 +703,15 @@ namespace Opm {
             // discretizations does not need to be synchronized across processes to be
             // consistent, this is not relevant for OPM-flow...
             ebosSolver.setMatrix(ebosJac);
+            if (param_.use_adaptive_linear_tolerance_) {
+                ebosSolver.setReduction(adaptiveLinearReduction_());
+            }
             ebosSolver.solve(x);
+
+            if (param_.use_chord_iterations_) {
+                chordJacobian_ = ebosJac.istlMatrix();
+                chordJacobianValid_ = true;
+            }
        }
 
 
@@ -559,10 +729,22 @@ namespace Opm {
                                                     // oil model do not care about the
                                                     // residual
 
+            if (useLocalizedReevaluation_()) {
+                updateChangedIntensiveQuantities_();
+                return;
+            }
+
             // if the solution is updated, the intensive quantities need to be recalculated
             ebosSimulator_.model().invalidateAndUpdateIntensiveQuantities(/*timeIdx=*/0);
         }
 
+        /// Number of cells (over all processes) whose primary variables
+        /// changed less than the localized re-evaluation tolerance in the
+        /// last update of the solution, so that their intensive quantities
+        /// were not re-evaluated.
+        long int skippedCellsLastUpdate() const
+        { return skippedCellsLastUpdate_; }
+
         /// Return true if output to cout is wanted.
         bool terminalOutputEnabled() const
         {
@@ -918,6 +1100,9 @@ namespace Opm {
             auto report = getReservoirConvergence(timer.currentStepLength(), iteration, B_avg, residual_norms);
             report += wellModel().getWellConvergence(B_avg);
 
+            // the subdomain solves of the NLDD solver use the same scaling
+            B_avg_ = B_avg;
+
             return report;
         }
 
@@ -995,8 +1180,64 @@ namespace Opm {
 
         std::vector<std::vector<double>> residual_norms_history_;
         double current_relaxation_;
+        // linear solver reduction of the last Newton iteration
+        double linear_reduction_;
+        // state of the reservoir and the wells before the last update, the
+        // full update, its current step length and the residual norms of the
+        // iterations for the backtracking line search
+        SolutionVector lineSearchSolution_;
+        WellState lineSearchWellState_;
+        BVector lineSearchUpdate_;
+        double line_search_step_;
+        int line_search_backtracks_;
+        std::vector<double> line_search_norms_;
+        // state before the last update for Anderson acceleration
+        SolutionVector andersonSolution_;
+        // cells owned by this process, to count each cell once in the
+        // reductions over all processes
+        std::vector<int> interiorCells_;
+        // Jacobian of the last Newton iteration for chord iterations
+        Mat chordJacobian_;
+        bool chordJacobianValid_;
+        // converged solutions, well states and end times of the last time
+        // steps for the solution predictor, oldest first
+        std::deque<SolutionVector> predictorSolutions_;
+        std::deque<WellState> predictorWellStates_;
+        std::deque<double> predictorTimes_;
         BVector dx_old_;
 
+        // primary variables at which the cached intensive quantities of each
+        // cell were evaluated, the element of each cell and the number of
+        // cells not re-evaluated in the last update when localized
+        // re-evaluation is enabled
+        SolutionVector evaluatedSolution_;
+        std::vector<Element> cellElements_;
+        long int skippedCellsLastUpdate_;
+        bool localizedReevaluation_;
+
+        /// A subdomain of the process-local grid for the nonlinear domain
+        /// decomposition (NLDD) solver.
+        struct LocalDomain
+        {
+            int index;
+            std::vector<int> cells;
+            std::vector<Element> elements;
+            Mat jacobian;
+            BVector residual;
+        };
+
+        std::vector<LocalDomain> domains_;
+        // indices of the domains which can be solved concurrently
+        std::vector<std::vector<int>> domainsByColor_;
+        // domain and index within the domain of each cell
+        std::vector<int> cellDomain_;
+        std::vector<int> cellIndexInDomain_;
+        std::vector<Scalar> B_avg_;
+
+        // linear solver setups of the sequential nonlinear solver
+        boost::property_tree::ptree pressureSolverPrm_;
+        boost::property_tree::ptree transportSolverPrm_;
+
         std::vector<StepReport> convergence_reports_;
     public:
         /// return the StandardWells object
@@ -1018,6 +1259,810 @@ namespace Opm {
 
     private:
 
+        // Re-evaluate the intensive quantities of the cells whose primary
+        // variables changed by more than the tolerance since their cached
+        // intensive quantities were evaluated. The update is applied to all
+        // cells, the other cells keep their cached intensive quantities until
+        // their accumulated change exceeds the tolerance or convergence is
+        // checked.
+        void updateChangedIntensiveQuantities_()
+        {
+            const SolutionVector& solution = ebosSimulator_.model().solution(/*timeIdx=*/0);
+            if (cellElements_.empty()) {
+                const auto& elemMapper = ebosSimulator_.model().elementMapper();
+                cellElements_.resize(solution.size());
+                for (const auto& elem : elements(ebosSimulator_.gridView())) {
+                    cellElements_[elemMapper.index(elem)] = elem;
+                }
+            }
+
+            const double tol = param_.localized_reevaluation_tolerance_;
+            const int numCells = cellElements_.size();
+            const int num_threads = ThreadManager::maxThreads();
+            std::vector<std::exception_ptr> thread_exceptions(num_threads);
+            long int numSkipped = 0;
+#ifdef _OPENMP
+#pragma omp parallel num_threads(num_threads) reduction(+:numSkipped)
+#endif
+            {
+                ElementContext elemCtx(ebosSimulator_);
+                const int thread_id = ThreadManager::threadId();
+#ifdef _OPENMP
+#pragma omp for schedule(dynamic, 64)
+#endif
+                for (int cell = 0; cell < numCells; ++cell) {
+                    if (isUpdateNegligible_(evaluatedSolution_[cell], solution[cell], tol)) {
+                        ++numSkipped;
+                        continue;
+                    }
+                    if (thread_exceptions[thread_id]) {
+                        continue;
+                    }
+                    try {
+                        reevaluateCell_(elemCtx, cellElements_[cell], cell);
+                    } catch (...) {
+                        thread_exceptions[thread_id] = std::current_exception();
+                    }
+                }
+            }
+            for (const auto& exception : thread_exceptions) {
+                if (exception) {
+                    std::rethrow_exception(exception);
+                }
+            }
+
+            skippedCellsLastUpdate_ = grid_.comm().sum(numSkipped);
+            if (terminal_output_) {
+                OpmLog::debug("    Localized update: " + std::to_string(skippedCellsLastUpdate_)
+                              + " of " + std::to_string(global_nc_) + " cells not re-evaluated");
+            }
+        }
+
+        // Number of cells (over all processes) whose cached intensive
+        // quantities were evaluated for other primary variables than the
+        // current ones. Always zero without localized re-evaluation.
+        long int countStaleCells_() const
+        {
+            if (!useLocalizedReevaluation_()) {
+                return 0;
+            }
+            const SolutionVector& solution = ebosSimulator_.model().solution(/*timeIdx=*/0);
+            long int numStale = 0;
+            for (unsigned cell = 0; cell < solution.size(); ++cell) {
+                if (!isUpdateNegligible_(evaluatedSolution_[cell], solution[cell], /*tol=*/0.0)) {
+                    ++numStale;
+                }
+            }
+            return grid_.comm().sum(numStale);
+        }
+
+        // Record that the intensive quantities of all cells were evaluated
+        // for the current primary variables.
+        void resetEvaluatedSolution_()
+        {
+            if (useLocalizedReevaluation_()) {
+                evaluatedSolution_ = ebosSimulator_.model().solution(/*timeIdx=*/0);
+            }
+        }
+
+        // recompute the intensive quantities of a cell and store them in the cache
+        void reevaluateCell_(ElementContext& elemCtx, const Element& elem, const unsigned globalIdx)
+        {
+            auto& ebosModel = ebosSimulator_.model();
+            // the element context takes the intensive quantities from the
+            // cache if the entry of the cell is valid
+            ebosModel.setIntensiveQuantitiesCacheEntryValidity(globalIdx, /*timeIdx=*/0, false);
+            elemCtx.updatePrimaryStencil(elem);
+            elemCtx.updatePrimaryIntensiveQuantities(/*timeIdx=*/0);
+            ebosModel.updateCachedIntensiveQuantities(elemCtx.intensiveQuantities(/*spaceIdx=*/0, /*timeIdx=*/0),
+                                                      globalIdx, /*timeIdx=*/0);
+            if (useLocalizedReevaluation_()) {
+                evaluatedSolution_[globalIdx] = ebosModel.solution(/*timeIdx=*/0)[globalIdx];
+            }
+        }
+
+        bool useLocalizedReevaluation_() const
+        {
+            return localizedReevaluation_;
+        }
+
+        bool useNldd_() const
+        {
+            return param_.nonlinear_solver_ == "nldd" && !isParallel();
+        }
+
+        // Partition the grid into subdomains using the sparsity pattern of
+        // the Jacobian and set up the local systems of equations.
+        void setupLocalDomains_()
+        {
+            const auto& jacobian = ebosSimulator_.model().linearizer().jacobian().istlMatrix();
+            const int numCells = jacobian.N();
+
+            std::vector<std::vector<int>> neighbours(numCells);
+            for (auto row = jacobian.begin(); row != jacobian.end(); ++row) {
+                for (auto col = row->begin(); col != row->end(); ++col) {
+                    neighbours[row.index()].push_back(col.index());
+                }
+            }
+
+            int numDomains = param_.num_local_domains_;
+            if (numDomains <= 0) {
+                numDomains = std::max(numCells / 1000, 1);
+            }
+            int numCreated = 0;
+            std::tie(cellDomain_, numCreated) = partitionCellsBreadthFirst(neighbours, numDomains);
+            const auto [colors, numColors] = colorDomains(neighbours, cellDomain_, numCreated);
+
+            domains_.clear();
+            domains_.resize(numCreated);
+            domainsByColor_.assign(numColors, {});
+            for (int domainIdx = 0; domainIdx < numCreated; ++domainIdx) {
+                domains_[domainIdx].index = domainIdx;
+                domainsByColor_[colors[domainIdx]].push_back(domainIdx);
+            }
+
+            cellIndexInDomain_.assign(numCells, -1);
+            const auto& elemMapper = ebosSimulator_.model().elementMapper();
+            for (const auto& elem : elements(ebosSimulator_.gridView(), Dune::Partitions::interior)) {
+                const int cell = elemMapper.index(elem);
+                auto& domain = domains_[cellDomain_[cell]];
+                cellIndexInDomain_[cell] = domain.cells.size();
+                domain.cells.push_back(cell);
+                domain.elements.push_back(elem);
+            }
+
+            for (auto& domain : domains_) {
+                const int size = domain.cells.size();
+                domain.jacobian.setBuildMode(Mat::random);
+                domain.jacobian.setSize(size, size);
+                for (int i = 0; i < size; ++i) {
+                    int rowSize = 0;
+                    for (const int nb : neighbours[domain.cells[i]]) {
+                        rowSize += (cellDomain_[nb] == domain.index);
+                    }
+                    domain.jacobian.setrowsize(i, rowSize);
+                }
+                domain.jacobian.endrowsizes();
+                for (int i = 0; i < size; ++i) {
+                    for (const int nb : neighbours[domain.cells[i]]) {
+                        if (cellDomain_[nb] == domain.index) {
+                            domain.jacobian.addindex(i, cellIndexInDomain_[nb]);
+                        }
+                    }
+                }
+                domain.jacobian.endindices();
+                domain.residual.resize(size);
+            }
+
+            if (terminal_output_) {
+                OpmLog::info("NLDD: partitioned the grid into " + std::to_string(numCreated)
+                             + " subdomains (" + std::to_string(numColors) + " colors)");
+            }
+        }
+
+        // Solve the nonlinear problems of all subdomains. Subdomains of the
+        // same color do not share faces and are solved concurrently.
+        //
+        // The subdomain problems only contain the reservoir equations. The
+        // wells enter them as the source terms of the last global assembly,
+        // i.e. the perforation rates do not react to the pressure changes
+        // of the local solves, and the well equations are only solved with
+        // the global Newton iteration which follows.
+        void solveLocalDomains_(SimulatorReportSingle& report)
+        {
+            if (domains_.empty()) {
+                setupLocalDomains_();
+            }
+
+            const int num_threads = ThreadManager::maxThreads();
+            unsigned localIterations = 0;
+            int numConverged = 0;
+            for (const auto& domainsOfColor : domainsByColor_) {
+                const int numDomainsOfColor = domainsOfColor.size();
+                std::vector<std::exception_ptr> thread_exceptions(num_threads);
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic) num_threads(num_threads) reduction(+:localIterations,numConverged)
+#endif
+                for (int k = 0; k < numDomainsOfColor; ++k) {
+                    const int thread_id = ThreadManager::threadId();
+                    if (thread_exceptions[thread_id]) {
+                        continue;
+                    }
+                    try {
+                        int iterations = 0;
+                        numConverged += solveDomain_(domains_[domainsOfColor[k]], iterations);
+                        localIterations += iterations;
+                    } catch (...) {
+                        thread_exceptions[thread_id] = std::current_exception();
+                    }
+                }
+                for (const auto& exception : thread_exceptions) {
+                    if (exception) {
+                        std::rethrow_exception(exception);
+                    }
+                }
+            }
+
+            report.total_local_newton_iterations += localIterations;
+            if (terminal_output_) {
+                OpmLog::debug("    NLDD: " + std::to_string(numConverged) + " of "
+                              + std::to_string(domains_.size()) + " subdomains converged, "
+                              + std::to_string(localIterations) + " local iterations");
+            }
+        }
+
+        // Local Newton iterations for a single subdomain with the cells
+        // outside of it kept fixed. If the local solve does not reduce the
+        // residual, the subdomain is reset to its initial state.
+        bool solveDomain_(LocalDomain& domain, int& iterations)
+        {
+            ElementContext elemCtx(ebosSimulator_);
+            auto& localLinearizer = ebosSimulator_.model().localLinearizer(ThreadManager::threadId());
+            auto& solution = ebosSimulator_.model().solution(/*timeIdx=*/0);
+            const int size = domain.cells.size();
+
+            std::vector<PrimaryVariables> initialState(size);
+            for (int i = 0; i < size; ++i) {
+                initialState[i] = solution[domain.cells[i]];
+            }
+
+            const double tolerance = param_.tolerance_cnv_ * param_.local_tolerance_scaling_cnv_;
+            double initialError = std::numeric_limits<double>::max();
+            double error = initialError;
+            iterations = 0;
+            try {
+                assembleDomain_(domain, elemCtx, localLinearizer);
+                initialError = domainCnvError_(domain);
+                error = initialError;
+
+                BVector dx(size);
+                while (error > tolerance && iterations < param_.max_local_solve_iterations_) {
+                    solveDomainLinearSystem_(domain, dx);
+                    updateDomainSolution_(domain, dx);
+                    for (int i = 0; i < size; ++i) {
+                        reevaluateCell_(elemCtx, domain.elements[i], domain.cells[i]);
+                    }
+                    assembleDomain_(domain, elemCtx, localLinearizer);
+                    error = domainCnvError_(domain);
+                    ++iterations;
+                }
+            }
+            catch (...) {
+                error = std::numeric_limits<double>::quiet_NaN();
+            }
+
+            if (!(error <= initialError)) {
+                for (int i = 0; i < size; ++i) {
+                    solution[domain.cells[i]] = initialState[i];
+                    reevaluateCell_(elemCtx, domain.elements[i], domain.cells[i]);
+                }
+                return false;
+            }
+            return error <= tolerance;
+        }
+
+        // Apply the update of a local Newton iteration to the cells of a
+        // subdomain. The Newton method of the model records the variable
+        // switches of all cells in shared members, so the updates of the
+        // subdomains which are solved concurrently are applied one at a
+        // time. They are cheap compared to the assembly and the linear solve
+        // of a local iteration.
+        void updateDomainSolution_(const LocalDomain& domain, const BVector& dx)
+        {
+            auto& ebosNewtonMethod = ebosSimulator_.model().newtonMethod();
+            auto& solution = ebosSimulator_.model().solution(/*timeIdx=*/0);
+            const int size = domain.cells.size();
+#ifdef _OPENMP
+#pragma omp critical(nldd_update_solution)
+#endif
+            {
+                for (int i = 0; i < size; ++i) {
+                    const int cell = domain.cells[i];
+                    ebosNewtonMethod.updatePrimaryVariables_(cell, solution[cell], solution[cell], dx[i], dx[i]);
+                }
+            }
+        }
+
+        // Assemble the residual and the Jacobian of a subdomain with respect
+        // to the primary variables of its own cells.
+        template <class LocalLinearizer>
+        void assembleDomain_(LocalDomain& domain,
+                             ElementContext& elemCtx,
+                             LocalLinearizer& localLinearizer) const
+        {
+            domain.jacobian = 0.0;
+            domain.residual = 0.0;
+            const int size = domain.cells.size();
+            for (int i = 0; i < size; ++i) {
+                localLinearizer.linearize(elemCtx, domain.elements[i]);
+                domain.residual[i] += localLinearizer.residual(/*primaryDofIdx=*/0);
+                for (unsigned dofIdx = 0; dofIdx < elemCtx.numDof(/*timeIdx=*/0); ++dofIdx) {
+                    const unsigned globJ = elemCtx.globalSpaceIndex(/*spaceIdx=*/dofIdx, /*timeIdx=*/0);
+                    if (cellDomain_[globJ] != domain.index) {
+                        continue;
+                    }
+                    domain.jacobian[cellIndexInDomain_[globJ]][i] += localLinearizer.jacobian(dofIdx, /*primaryDofIdx=*/0);
+                }
+            }
+        }
+
+        // maximum CNV error of the cells of a subdomain, scaled like the
+        // global CNV error
+        double domainCnvError_(const LocalDomain& domain) const
+        {
+            const auto& ebosModel = ebosSimulator_.model();
+            const auto& ebosProblem = ebosSimulator_.problem();
+            const double dt = ebosSimulator_.timeStepSize();
+            double maxError = 0.0;
+            const int size = domain.cells.size();
+            for (int i = 0; i < size; ++i) {
+                const int cell = domain.cells[i];
+                const double pvValue = ebosProblem.referencePorosity(cell, /*timeIdx=*/0) * ebosModel.dofTotalVolume(cell);
+                for (int eqIdx = 0; eqIdx < numEq; ++eqIdx) {
+                    const double cnv = std::abs(domain.residual[i][eqIdx]) * dt * B_avg_[eqIdx] / pvValue;
+                    if (!std::isfinite(cnv)) {
+                        return std::numeric_limits<double>::quiet_NaN();
+                    }
+                    maxError = std::max(maxError, cnv);
+                }
+            }
+            return maxError;
+        }
+
+        void solveDomainLinearSystem_(const LocalDomain& domain, BVector& dx) const
+        {
+            typedef Dune::MatrixAdapter<Mat, BVector, BVector> DomainOperator;
+            typedef Dune::SeqILU<Mat, BVector, BVector> DomainPreconditioner;
+
+            DomainOperator op(domain.jacobian);
+            DomainPreconditioner precond(domain.jacobian, 0, 1.0); // ILU0
+            Dune::SeqScalarProduct<BVector> scalarProduct;
+            Dune::BiCGSTABSolver<BVector> solver(op, scalarProduct, precond,
+                                                 /*reduction=*/1e-3, /*maxIter=*/200, /*verbosity=*/0);
+
+            BVector rhs(domain.residual);
+            dx = 0.0;
+            Dune::InverseOperatorResult result;
+            solver.apply(dx, rhs, result);
+        }
+
+        // Linear solver reduction for the current Newton iteration from the
+        // Eisenstat-Walker forcing terms (choice 2, gamma = 0.9, alpha = 2),
+        // using the largest CNV error as the nonlinear residual norm.
+        double adaptiveLinearReduction_()
+        {
+            const double gamma = 0.9;
+            const double alpha = 2.0;
+            const double etaMax = param_.adaptive_linear_tolerance_max_;
+            const double etaMin = param_.adaptive_linear_tolerance_min_;
+
+            double eta = etaMax;
+            const int numNorms = residual_norms_history_.size();
+            if (numNorms > 1) {
+                const double currentNorm = residualNorm_(residual_norms_history_[numNorms - 1]);
+                const double previousNorm = residualNorm_(residual_norms_history_[numNorms - 2]);
+                if (previousNorm > 0.0 && std::isfinite(currentNorm)) {
+                    const double ratio = currentNorm / previousNorm;
+                    eta = gamma * std::pow(ratio, alpha);
+                    // safeguard against a too rapid decrease of the forcing term
+                    const double previousEta = gamma * std::pow(linear_reduction_, alpha);
+                    if (previousEta > 0.1) {
+                        eta = std::max(eta, previousEta);
+                    }
+                    eta = std::clamp(eta, etaMin, etaMax);
+                }
+            }
+            linear_reduction_ = eta;
+
+            if (terminal_output_) {
+                std::ostringstream msg;
+                msg << "    Newton iteration " << numNorms - 1 << ": linear solver reduction " << std::scientific << std::setprecision(2) << eta;
+                OpmLog::debug(msg.str());
+            }
+            return eta;
+        }
+
+        // nonlinear residual norm used by the adaptive linear tolerance and
+        // the chord iterations: the largest CNV error
+        static double residualNorm_(const std::vector<double>& residualNorms)
+        {
+            return residualNorms.empty() ? 0.0 : *std::max_element(residualNorms.begin(), residualNorms.end());
+        }
+
+        // merit function of the line search: the largest CNV error and the
+        // largest well residual, both relative to their tolerance
+        double lineSearchNorm_(const std::vector<double>& residualNorms) const
+        {
+            return std::max(residualNorm_(residualNorms) / param_.tolerance_cnv_,
+                            wellModel().relativeWellResidual(B_avg_));
+        }
+
+        // Backtracking line search on the residual: if the last update did not
+        // sufficiently decrease the residual norm of the reservoir and the
+        // wells, return to the state before it and apply half of the previous
+        // step instead. The reservoir update is applied again with the
+        // reduced step, while the wells are reset to their state before the
+        // update and solved for the new reservoir state. The residual of the
+        // rejected state is removed from the history.
+        // Returns true if the update was rejected.
+        bool backtrackLastUpdate_(const int maxBacktracks)
+        {
+            const int numNorms = line_search_norms_.size();
+            if (numNorms < 2 || lineSearchSolution_.size() == 0) {
+                return false;
+            }
+            const double currentNorm = line_search_norms_[numNorms - 1];
+            const double previousNorm = line_search_norms_[numNorms - 2];
+            const bool sufficientDecrease = currentNorm <= (1.0 - 1e-4 * line_search_step_) * previousNorm;
+            if (sufficientDecrease || line_search_backtracks_ >= maxBacktracks) {
+                line_search_step_ = 1.0;
+                line_search_backtracks_ = 0;
+                return false;
+            }
+
+            residual_norms_history_.pop_back();
+            line_search_norms_.pop_back();
+            line_search_step_ *= 0.5;
+            ++line_search_backtracks_;
+
+            BVector dx(lineSearchUpdate_);
+            dx *= line_search_step_;
+            SolutionVector& solution = ebosSimulator_.model().solution(/*timeIdx=*/0);
+            solution = lineSearchSolution_;
+            ebosSimulator_.model().newtonMethod().update_(/*nextSolution=*/solution,
+                                                          /*curSolution=*/solution,
+                                                          /*update=*/dx,
+                                                          /*resid=*/dx);
+            ebosSimulator_.model().invalidateAndUpdateIntensiveQuantities(/*timeIdx=*/0);
+            resetEvaluatedSolution_();
+            wellModel().resetAndSolveWells(lineSearchWellState_);
+
+            if (terminal_output_) {
+                OpmLog::debug("    Line search: residual increased from " + std::to_string(previousNorm)
+                              + " to " + std::to_string(currentNorm) + ", step length reduced to "
+                              + std::to_string(line_search_step_));
+            }
+            return true;
+        }
+
+        // The update applied by updateSolution() to the state before: dx
+        // after the chopping of the model. The cells which switched their
+        // primary variables keep the requested update, since the differences
+        // of the primary variables have no meaning for them.
+        BVector appliedUpdate_(const SolutionVector& before, const BVector& dx) const
+        {
+            const SolutionVector& after = ebosSimulator_.model().solution(/*timeIdx=*/0);
+            BVector applied(dx);
+            for (std::size_t cell = 0; cell < applied.size(); ++cell) {
+                if (before[cell].primaryVarsMeaning() != after[cell].primaryVarsMeaning()) {
+                    continue;
+                }
+                for (unsigned pvIdx = 0; pvIdx < numEq; ++pvIdx) {
+                    applied[cell][pvIdx] = before[cell][pvIdx] - after[cell][pvIdx];
+                }
+            }
+            return applied;
+        }
+
+        // Chord iterations are used while the time step is close to linear,
+        // i.e., the solution changes little over the step and the last
+        // iteration reduced the residual sufficiently.
+        bool useChordIteration_() const
+        {
+            if (!param_.use_chord_iterations_ || !chordJacobianValid_) {
+                return false;
+            }
+            const auto& matrix = ebosSimulator_.model().linearizer().jacobian().istlMatrix();
+            if (matrix.N() != chordJacobian_.N() || matrix.nonzeroes() != chordJacobian_.nonzeroes()) {
+                return false;
+            }
+            const int numNorms = residual_norms_history_.size();
+            if (numNorms < 2) {
+                return false;
+            }
+            const double currentNorm = residualNorm_(residual_norms_history_[numNorms - 1]);
+            const double previousNorm = residualNorm_(residual_norms_history_[numNorms - 2]);
+            if (!(currentNorm <= param_.chord_residual_reduction_ * previousNorm)) {
+                return false;
+            }
+            return relativeChange() < param_.chord_max_relative_change_;
+        }
+
+        // Solve with the Jacobian and the preconditioner of the last Newton
+        // iteration. The values of the freshly assembled Jacobian are
+        // replaced by the saved ones, so that the linear operator matches the
+        // preconditioner, and only the residual is updated.
+        void solveChordSystem_(BVector& x)
+        {
+            auto& matrix = ebosSimulator_.model().linearizer().jacobian().istlMatrix();
+            auto& ebosResid = ebosSimulator_.model().linearizer().residual();
+            auto savedRow = chordJacobian_.begin();
+            for (auto row = matrix.begin(); row != matrix.end(); ++row, ++savedRow) {
+                auto savedCol = savedRow->begin();
+                for (auto col = row->begin(); col != row->end(); ++col, ++savedCol) {
+                    *col = *savedCol;
+                }
+            }
+
+            x = 0.0;
+            auto& ebosSolver = ebosSimulator_.model().newtonMethod().linearSolver();
+            ebosSolver.prepareReusingSetup(ebosResid);
+            if (param_.use_adaptive_linear_tolerance_) {
+                ebosSolver.setReduction(adaptiveLinearReduction_());
+            }
+            ebosSolver.solve(x);
+
+            if (terminal_output_) {
+                OpmLog::debug("    Chord iteration with the Jacobian of the previous Newton iteration");
+            }
+        }
+
+        // Remember the converged state of the time step for the solution
+        // predictor of the following time steps.
+        void storeConvergedState_()
+        {
+            predictorSolutions_.push_back(ebosSimulator_.model().solution(/*timeIdx=*/0));
+            predictorWellStates_.push_back(wellModel().wellState());
+            predictorTimes_.push_back(ebosSimulator_.time() + ebosSimulator_.timeStepSize());
+            while (static_cast<int>(predictorTimes_.size()) > param_.solution_predictor_order_ + 1) {
+                predictorSolutions_.pop_front();
+                predictorWellStates_.pop_front();
+                predictorTimes_.pop_front();
+            }
+        }
+
+        // Lagrange extrapolation coefficients of the stored states for the
+        // end of the time step starting at stepStart. Empty if there are not
+        // enough stored states or if they do not end at the start of the
+        // time step, e.g. after a restart.
+        std::vector<double> predictorCoefficients_(const double stepStart, const double stepEnd)
+        {
+            const int numStates = predictorTimes_.size();
+            if (numStates < 2
+                || std::abs(predictorTimes_.back() - stepStart) > 1e-6 * std::max(std::abs(stepStart), 1.0))
+            {
+                predictorSolutions_.clear();
+                predictorWellStates_.clear();
+                predictorTimes_.clear();
+                return {};
+            }
+
+            std::vector<double> coefficients(numStates, 1.0);
+            for (int i = 0; i < numStates; ++i) {
+                for (int j = 0; j < numStates; ++j) {
+                    if (j != i) {
+                        coefficients[i] *= (stepEnd - predictorTimes_[j]) / (predictorTimes_[i] - predictorTimes_[j]);
+                    }
+                }
+            }
+            return coefficients;
+        }
+
+        // Extrapolate the primary variables to the end of the time step. The
+        // prediction is applied as a regular Newton update, so that the
+        // chopping of the update, the switching of the primary variables and
+        // the physical bounds are honoured. Cells whose primary variables
+        // changed their meaning during the stored time steps are not
+        // extrapolated.
+        void predictSolution_(const std::vector<double>& coefficients)
+        {
+            if (coefficients.empty()) {
+                return;
+            }
+            SolutionVector& solution = ebosSimulator_.model().solution(/*timeIdx=*/0);
+            const int numStates = coefficients.size();
+            BVector dx(solution.size());
+            dx = 0.0;
+            for (unsigned cell = 0; cell < solution.size(); ++cell) {
+                const auto meaning = solution[cell].primaryVarsMeaning();
+                bool sameMeaning = true;
+                for (int i = 0; i < numStates; ++i) {
+                    sameMeaning = sameMeaning && predictorSolutions_[i][cell].primaryVarsMeaning() == meaning;
+                }
+                if (!sameMeaning) {
+                    continue;
+                }
+                for (int pvIdx = 0; pvIdx < numEq; ++pvIdx) {
+                    double predicted = 0.0;
+                    for (int i = 0; i < numStates; ++i) {
+                        predicted += coefficients[i] * predictorSolutions_[i][cell][pvIdx];
+                    }
+                    // Newton updates are subtracted from the solution
+                    dx[cell][pvIdx] = solution[cell][pvIdx] - predicted;
+                }
+            }
+
+            ebosSimulator_.model().newtonMethod().update_(/*nextSolution=*/solution,
+                                                          /*curSolution=*/solution,
+                                                          /*update=*/dx,
+                                                          /*resid=*/dx);
+            ebosSimulator_.model().invalidateAndUpdateIntensiveQuantities(/*timeIdx=*/0);
+        }
+
+        bool useSequential_() const
+        {
+            return param_.nonlinear_solver_ == "sequential" && !isParallel();
+        }
+
+        // One outer iteration of the sequential implicit solver: the
+        // pressure is updated from the pressure equation, then the other
+        // primary variables are updated by transport solves with the
+        // pressure, and thereby the total fluxes, kept fixed. Convergence is
+        // checked on the coupled residual by the next call of
+        // nonlinearIteration().
+        void solveSequential_(const SimulatorTimerInterface& timer,
+                              const int iteration,
+                              SimulatorReportSingle& report)
+        {
+            auto& jacobian = ebosSimulator_.model().linearizer().jacobian();
+            auto& residual = ebosSimulator_.model().linearizer().residual();
+            BVector x(UgGridHelpers::numCells(grid_));
+            Dune::Timer perfTimer;
+
+            perfTimer.start();
+            wellModel().linearize(jacobian, residual);
+            report.total_linear_iterations += solvePressureSystem_(jacobian.istlMatrix(), residual, x);
+            report.linear_solve_time += perfTimer.stop();
+
+            perfTimer.reset();
+            perfTimer.start();
+            wellModel().postSolve(x);
+            updateSolution(x);
+            report.update_time += perfTimer.stop();
+
+            for (int transportIter = 0; transportIter < param_.sequential_transport_iterations_; ++transportIter) {
+                perfTimer.reset();
+                perfTimer.start();
+                report += assembleReservoir(timer, iteration);
+                report.total_linearizations += 1;
+                report.assemble_time += perfTimer.stop();
+                if (transportCnvError_(residual) < param_.tolerance_cnv_) {
+                    break;
+                }
+
+                perfTimer.reset();
+                perfTimer.start();
+                wellModel().linearize(jacobian, residual);
+                report.total_linear_iterations += solveTransportSystem_(jacobian.istlMatrix(), residual, x);
+                report.linear_solve_time += perfTimer.stop();
+
+                perfTimer.reset();
+                perfTimer.start();
+                wellModel().postSolve(x);
+                updateSolution(x);
+                report.update_time += perfTimer.stop();
+            }
+        }
+
+        // Solve the pressure equation obtained by reducing each block row of
+        // the linearized system with IMPES weights. Only the pressure
+        // component of the update is set.
+        int solvePressureSystem_(const Mat& jacobian, const BVector& residual, BVector& dx)
+        {
+            const int pressureIdx = Indices::pressureSwitchIdx;
+            const int nc = jacobian.N();
+            BVector weights(nc);
+            if (param_.sequential_true_impes_weights_) {
+                ElementContext elemCtx(ebosSimulator_);
+                Amg::getTrueImpesWeights(pressureIdx, weights, ebosSimulator_.gridView(), elemCtx,
+                                         ebosSimulator_.model(), ThreadManager::threadId());
+            }
+            else {
+                Amg::getQuasiImpesWeights(jacobian, pressureIdx, /*transpose=*/false, weights);
+            }
+
+            PressureMatrix pressureMatrix(nc, nc, jacobian.nonzeroes(), PressureMatrix::row_wise);
+            for (auto row = pressureMatrix.createbegin(); row != pressureMatrix.createend(); ++row) {
+                const auto& jacRow = jacobian[row.index()];
+                for (auto col = jacRow.begin(); col != jacRow.end(); ++col) {
+                    row.insert(col.index());
+                }
+            }
+            PressureVector rhs(nc);
+            for (auto row = jacobian.begin(); row != jacobian.end(); ++row) {
+                const auto& w = weights[row.index()];
+                auto& pressureRow = pressureMatrix[row.index()];
+                for (auto col = row->begin(); col != row->end(); ++col) {
+                    Scalar value = 0.0;
+                    for (int eqIdx = 0; eqIdx < numEq; ++eqIdx) {
+                        value += w[eqIdx] * (*col)[eqIdx][pressureIdx];
+                    }
+                    pressureRow[col.index()] = value;
+                }
+                rhs[row.index()] = w.dot(residual[row.index()]);
+            }
+
+            typedef Dune::MatrixAdapter<PressureMatrix, PressureVector, PressureVector> PressureOperator;
+            PressureOperator op(pressureMatrix);
+            Dune::FlexibleSolver<PressureMatrix, PressureVector> solver(op, pressureSolverPrm_);
+            PressureVector dp(nc);
+            dp = 0.0;
+            Dune::InverseOperatorResult result;
+            solver.apply(dp, rhs, result);
+            if (!result.converged) {
+                OPM_THROW(NumericalIssue, "Pressure solve of the sequential solver did not converge.");
+            }
+
+            dx = 0.0;
+            for (int cell = 0; cell < nc; ++cell) {
+                dx[cell][pressureIdx] = dp[cell][0];
+            }
+            return result.iterations;
+        }
+
+        // Solve the linearized system for the non-pressure primary
+        // variables with the pressure fixed. The equation at the pressure
+        // index, which the pressure equation stands in for, is replaced by
+        // dp = 0.
+        int solveTransportSystem_(const Mat& jacobian, const BVector& residual, BVector& dx)
+        {
+            const int pressureIdx = Indices::pressureSwitchIdx;
+            Mat transportMatrix(jacobian);
+            BVector rhs(residual);
+            for (auto row = transportMatrix.begin(); row != transportMatrix.end(); ++row) {
+                for (auto col = row->begin(); col != row->end(); ++col) {
+                    for (int k = 0; k < numEq; ++k) {
+                        (*col)[pressureIdx][k] = 0.0;
+                        (*col)[k][pressureIdx] = 0.0;
+                    }
+                    if (col.index() == row.index()) {
+                        (*col)[pressureIdx][pressureIdx] = 1.0;
+                    }
+                }
+                rhs[row.index()][pressureIdx] = 0.0;
+            }
+
+            typedef Dune::MatrixAdapter<Mat, BVector, BVector> TransportOperator;
+            TransportOperator op(transportMatrix);
+            Dune::FlexibleSolver<Mat, BVector> solver(op, transportSolverPrm_);
+            dx = 0.0;
+            Dune::InverseOperatorResult result;
+            solver.apply(dx, rhs, result);
+            if (!result.converged) {
+                OPM_THROW(NumericalIssue, "Transport solve of the sequential solver did not converge.");
+            }
+            return result.iterations;
+        }
+
+        // maximum CNV error of the equations solved by the transport step
+        double transportCnvError_(const BVector& residual) const
+        {
+            const auto& ebosModel = ebosSimulator_.model();
+            const auto& ebosProblem = ebosSimulator_.problem();
+            const double dt = ebosSimulator_.timeStepSize();
+            double maxError = 0.0;
+            const int nc = residual.size();
+            for (int cell = 0; cell < nc; ++cell) {
+                const double pvValue = ebosProblem.referencePorosity(cell, /*timeIdx=*/0) * ebosModel.dofTotalVolume(cell);
+                for (int eqIdx = 0; eqIdx < numEq; ++eqIdx) {
+                    if (eqIdx == Indices::pressureSwitchIdx) {
+                        continue;
+                    }
+                    maxError = std::max(maxError, std::abs(residual[cell][eqIdx]) * dt * B_avg_[eqIdx] / pvValue);
+                }
+            }
+            return maxError;
+        }
+
+        // Whether the intensive quantities evaluated for oldPriVars are
+        // still acceptable for newPriVars, i.e. whether no primary variable
+        // changed by more than tol relative to its magnitude (at least one).
+        static bool isUpdateNegligible_(const PrimaryVariables& oldPriVars,
+                                        const PrimaryVariables& newPriVars,
+                                        const double tol)
+        {
+            if (oldPriVars.primaryVarsMeaning() != newPriVars.primaryVarsMeaning()) {
+                return false;
+            }
+            for (unsigned pvIdx = 0; pvIdx < numEq; ++pvIdx) {
+                const double scale = std::max(std::abs(oldPriVars[pvIdx]), 1.0);
+                if (std::abs(newPriVars[pvIdx] - oldPriVars[pvIdx]) > tol * scale) {
+                    return false;
+                }
+            }
+            return true;
+        }
+
         double dpMaxRel() const { return param_.dp_max_rel_; }
         double dsMax() const { return param_.ds_max_; }
         double drMaxRel() const { return param_.dr_max_rel_; }
@@ -24,6 +24,7 @@
 #include <opm/models/utils/parametersystem.hh>
 
 #include <ebos/eclbasevanguard.hh>
+#include <stdexcept>
 #include <string>
 
 namespace Opm::Properties {
@@ -104,6 +105,70 @@ template<class TypeTag, class MyTypeTag>
 struct EnableWellOperabilityCheck {
     using type = UndefinedProperty;
 };
+template<class TypeTag, class MyTypeTag>
+struct UseLocalizedReevaluation {
+    using type = UndefinedProperty;
+};
+template<class TypeTag, class MyTypeTag>
+struct LocalizedReevaluationTolerance {
+    using type = UndefinedProperty;
+};
+template<class TypeTag, class MyTypeTag>
+struct NonlinearSolver {
+    using type = UndefinedProperty;
+};
+template<class TypeTag, class MyTypeTag>
+struct NumLocalDomains {
+    using type = UndefinedProperty;
+};
+template<class TypeTag, class MyTypeTag>
+struct MaxLocalSolveIterations {
+    using type = UndefinedProperty;
+};
+template<class TypeTag, class MyTypeTag>
+struct LocalToleranceScalingCnv {
+    using type = UndefinedProperty;
+};
+template<class TypeTag, class MyTypeTag>
+struct SequentialTransportIterations {
+    using type = UndefinedProperty;
+};
+template<class TypeTag, class MyTypeTag>
+struct SequentialTrueImpesWeights {
+    using type = UndefinedProperty;
+};
+template<class TypeTag, class MyTypeTag>
+struct UseAdaptiveLinearTolerance {
+    using type = UndefinedProperty;
+};
+template<class TypeTag, class MyTypeTag>
+struct AdaptiveLinearToleranceMax {
+    using type = UndefinedProperty;
+};
+template<class TypeTag, class MyTypeTag>
+struct AdaptiveLinearToleranceMin {
+    using type = UndefinedProperty;
+};
+template<class TypeTag, class MyTypeTag>
+struct UseChordIterations {
+    using type = UndefinedProperty;
+};
+template<class TypeTag, class MyTypeTag>
+struct ChordResidualReduction {
+    using type = UndefinedProperty;
+};
+template<class TypeTag, class MyTypeTag>
+struct ChordMaxRelativeChange {
+    using type = UndefinedProperty;
+};
+template<class TypeTag, class MyTypeTag>
+struct SolutionPredictorOrder {
+    using type = UndefinedProperty;
+};
+template<class TypeTag, class MyTypeTag>
+struct GasLiftGroupAllocation {
+    using type = UndefinedProperty;
+};
 
 // parameters for multisegment wells
 template<class TypeTag, class MyTypeTag>
@@ -282,6 +347,76 @@ struct RelaxedPressureTolInnerIterMsw<TypeTag, TTag::FlowModelParameters> {
     using type = GetPropType<TypeTag, Scalar>;
     static constexpr type value = 0.5e5;
 };
+template<class TypeTag>
+struct UseLocalizedReevaluation<TypeTag, TTag::FlowModelParameters> {
+    static constexpr bool value = false;
+};
+template<class TypeTag>
+struct LocalizedReevaluationTolerance<TypeTag, TTag::FlowModelParameters> {
+    using type = GetPropType<TypeTag, Scalar>;
+    static constexpr type value = 1e-6;
+};
+template<class TypeTag>
+struct NonlinearSolver<TypeTag, TTag::FlowModelParameters> {
+    static constexpr auto value = "newton";
+};
+template<class TypeTag>
+struct NumLocalDomains<TypeTag, TTag::FlowModelParameters> {
+    static constexpr int value = 0;
+};
+template<class TypeTag>
+struct MaxLocalSolveIterations<TypeTag, TTag::FlowModelParameters> {
+    static constexpr int value = 20;
+};
+template<class TypeTag>
+struct LocalToleranceScalingCnv<TypeTag, TTag::FlowModelParameters> {
+    using type = GetPropType<TypeTag, Scalar>;
+    static constexpr type value = 0.1;
+};
+template<class TypeTag>
+struct SequentialTransportIterations<TypeTag, TTag::FlowModelParameters> {
+    static constexpr int value = 3;
+};
+template<class TypeTag>
+struct SequentialTrueImpesWeights<TypeTag, TTag::FlowModelParameters> {
+    static constexpr bool value = false;
+};
+template<class TypeTag>
+struct UseAdaptiveLinearTolerance<TypeTag, TTag::FlowModelParameters> {
+    static constexpr bool value = false;
+};
+template<class TypeTag>
+struct AdaptiveLinearToleranceMax<TypeTag, TTag::FlowModelParameters> {
+    using type = GetPropType<TypeTag, Scalar>;
+    static constexpr type value = 0.1;
+};
+template<class TypeTag>
+struct AdaptiveLinearToleranceMin<TypeTag, TTag::FlowModelParameters> {
+    using type = GetPropType<TypeTag, Scalar>;
+    static constexpr type value = 1e-4;
+};
+template<class TypeTag>
+struct UseChordIterations<TypeTag, TTag::FlowModelParameters> {
+    static constexpr bool value = false;
+};
+template<class TypeTag>
+struct ChordResidualReduction<TypeTag, TTag::FlowModelParameters> {
+    using type = GetPropType<TypeTag, Scalar>;
+    static constexpr type value = 0.5;
+};
+template<class TypeTag>
+struct ChordMaxRelativeChange<TypeTag, TTag::FlowModelParameters> {
+    using type = GetPropType<TypeTag, Scalar>;
+    static constexpr type value = 1e-3;
+};
+template<class TypeTag>
+struct SolutionPredictorOrder<TypeTag, TTag::FlowModelParameters> {
+    static constexpr int value = 0;
+};
+template<class TypeTag>
+struct GasLiftGroupAllocation<TypeTag, TTag::FlowModelParameters> {
+    static constexpr bool value = false;
+};
 
 // if openMP is available, determine the number threads per process automatically.
 #if _OPENMP
@@ -384,6 +519,62 @@ namespace Opm
         // Whether to add influences of wells between cells to the matrix and preconditioner matrix
         bool matrix_add_well_contributions_;
 
+        /// Only re-evaluate the intensive quantities of cells whose primary
+        /// variables changed in the last Newton update.
+        bool use_localized_reevaluation_;
+
+        /// Relative change of the primary variables of a cell below which its
+        /// intensive quantities are not re-evaluated.
+        double localized_reevaluation_tolerance_;
+
+        /// Nonlinear solver type: "newton", "nldd" (nonlinear domain decomposition)
+        /// or "sequential" (sequential implicit pressure/transport split).
+        std::string nonlinear_solver_;
+
+        /// Number of subdomains per process for the NLDD solver (0: automatic).
+        int num_local_domains_;
+
+        /// Maximum number of Newton iterations of a subdomain solve.
+        int max_local_solve_iterations_;
+
+        /// Factor applied to the CNV tolerance for the subdomain solves.
+        double local_tolerance_scaling_cnv_;
+
+        /// Number of transport solves per pressure solve in the sequential solver.
+        int sequential_transport_iterations_;
+
+        /// Use true-IMPES instead of quasi-IMPES weights for the pressure equation.
+        bool sequential_true_impes_weights_;
+
+        /// Choose the linear solver reduction per Newton iteration by the
+        /// Eisenstat-Walker forcing terms.
+        bool use_adaptive_linear_tolerance_;
+
+        /// Bounds of the adaptively chosen linear solver reduction.
+        double adaptive_linear_tolerance_max_;
+        double adaptive_linear_tolerance_min_;
+
+        /// Allow chord iterations, which reuse the Jacobian and the
+        /// preconditioner of the previous Newton iteration.
+        bool use_chord_iterations_;
+
+        /// Largest ratio of consecutive residual norms for which chord
+        /// iterations are continued.
+        double chord_residual_reduction_;
+
+        /// Largest relative change of the solution over the time step for
+        /// which chord iterations are used.
+        double chord_max_relative_change_;
+
+        /// Order of the extrapolation of the solution from the previous time
+        /// steps to the initial Newton iterate (0: no prediction).
+        int solution_predictor_order_;
+
+        /// Allocate the lift gas increments over all gas lifted wells by their
+        /// incremental gradients and within the lift gas limits of the groups,
+        /// instead of optimizing each well on its own.
+        bool glift_group_allocation_;
+
         /// Construct from user parameters or defaults.
         BlackoilModelParametersEbos()
         {
@@ -414,6 +605,32 @@ namespace Opm
             update_equations_scaling_ = EWOMS_GET_PARAM(TypeTag, bool, UpdateEquationsScaling);
             use_update_stabilization_ = EWOMS_GET_PARAM(TypeTag, bool, UseUpdateStabilization);
             matrix_add_well_contributions_ = EWOMS_GET_PARAM(TypeTag, bool, MatrixAddWellContributions);
+            use_localized_reevaluation_ = EWOMS_GET_PARAM(TypeTag, bool, UseLocalizedReevaluation);
+            localized_reevaluation_tolerance_ = EWOMS_GET_PARAM(TypeTag, Scalar, LocalizedReevaluationTolerance);
+            nonlinear_solver_ = EWOMS_GET_PARAM(TypeTag, std::string, NonlinearSolver);
+            if (nonlinear_solver_ != "newton" && nonlinear_solver_ != "nldd" && nonlinear_solver_ != "sequential") {
+                throw std::runtime_error("Unknown nonlinear solver type: " + nonlinear_solver_);
+            }
+            if (nonlinear_solver_ == "sequential" && !matrix_add_well_contributions_) {
+                throw std::runtime_error("The sequential nonlinear solver requires the well contributions "
+                                         "to be added to the matrix (MatrixAddWellContributions)");
+            }
+            num_local_domains_ = EWOMS_GET_PARAM(TypeTag, int, NumLocalDomains);
+            max_local_solve_iterations_ = EWOMS_GET_PARAM(TypeTag, int, MaxLocalSolveIterations);
+            local_tolerance_scaling_cnv_ = EWOMS_GET_PARAM(TypeTag, Scalar, LocalToleranceScalingCnv);
+            sequential_transport_iterations_ = EWOMS_GET_PARAM(TypeTag, int, SequentialTransportIterations);
+            sequential_true_impes_weights_ = EWOMS_GET_PARAM(TypeTag, bool, SequentialTrueImpesWeights);
+            use_adaptive_linear_tolerance_ = EWOMS_GET_PARAM(TypeTag, bool, UseAdaptiveLinearTolerance);
+            adaptive_linear_tolerance_max_ = EWOMS_GET_PARAM(TypeTag, Scalar, AdaptiveLinearToleranceMax);
+            adaptive_linear_tolerance_min_ = EWOMS_GET_PARAM(TypeTag, Scalar, AdaptiveLinearToleranceMin);
+            use_chord_iterations_ = EWOMS_GET_PARAM(TypeTag, bool, UseChordIterations);
+            chord_residual_reduction_ = EWOMS_GET_PARAM(TypeTag, Scalar, ChordResidualReduction);
+            chord_max_relative_change_ = EWOMS_GET_PARAM(TypeTag, Scalar, ChordMaxRelativeChange);
+            solution_predictor_order_ = EWOMS_GET_PARAM(TypeTag, int, SolutionPredictorOrder);
+            if (solution_predictor_order_ < 0 || solution_predictor_order_ > 2) {
+                throw std::runtime_error("The order of the solution predictor must be 0, 1 or 2");
+            }
+            glift_group_allocation_ = EWOMS_GET_PARAM(TypeTag, bool, GasLiftGroupAllocation);
 
             deck_file_name_ = EWOMS_GET_PARAM(TypeTag, std::string, EclDeckFileName);
         }
@@ -450,6 +667,22 @@ namespace Opm
             EWOMS_REGISTER_PARAM(TypeTag, bool, UseUpdateStabilization, "Try to detect and correct oscillations or stagnation during the Newton method");
             EWOMS_REGISTER_PARAM(TypeTag, bool, MatrixAddWellContributions, "Explicitly specify the influences of wells between cells in the Jacobian and preconditioner matrices");
             EWOMS_REGISTER_PARAM(TypeTag, bool, EnableWellOperabilityCheck, "Enable the well operability checking");
+            EWOMS_REGISTER_PARAM(TypeTag, bool, UseLocalizedReevaluation, "Skip the re-evaluation of the intensive quantities of cells whose primary variables did not change significantly during a Newton update (requires the intensive quantity cache)");
+            EWOMS_REGISTER_PARAM(TypeTag, Scalar, LocalizedReevaluationTolerance, "Relative change of the primary variables below which a cell is not re-evaluated if localized re-evaluation is enabled");
+            EWOMS_REGISTER_PARAM(TypeTag, std::string, NonlinearSolver, "Choose nonlinear solver. Valid choices are newton, nldd (nonlinear domain decomposition) or sequential (sequential implicit pressure/transport split)");
+            EWOMS_REGISTER_PARAM(TypeTag, int, NumLocalDomains, "Number of subdomains per process for the NLDD nonlinear solver (0: about 1000 cells per subdomain)");
+            EWOMS_REGISTER_PARAM(TypeTag, int, MaxLocalSolveIterations, "Maximum number of Newton iterations of a subdomain solve in the NLDD nonlinear solver");
+            EWOMS_REGISTER_PARAM(TypeTag, Scalar, LocalToleranceScalingCnv, "Factor applied to the CNV tolerance for the subdomain solves of the NLDD nonlinear solver");
+            EWOMS_REGISTER_PARAM(TypeTag, int, SequentialTransportIterations, "Maximum number of transport solves after each pressure solve of the sequential nonlinear solver");
+            EWOMS_REGISTER_PARAM(TypeTag, bool, SequentialTrueImpesWeights, "Use true-IMPES instead of quasi-IMPES weights to form the pressure equation of the sequential nonlinear solver");
+            EWOMS_REGISTER_PARAM(TypeTag, bool, UseAdaptiveLinearTolerance, "Choose the linear solver reduction of each Newton iteration from the decrease of the nonlinear residual (Eisenstat-Walker)");
+            EWOMS_REGISTER_PARAM(TypeTag, Scalar, AdaptiveLinearToleranceMax, "Largest linear solver reduction used with an adaptive linear tolerance");
+            EWOMS_REGISTER_PARAM(TypeTag, Scalar, AdaptiveLinearToleranceMin, "Smallest linear solver reduction used with an adaptive linear tolerance");
+            EWOMS_REGISTER_PARAM(TypeTag, bool, UseChordIterations, "Allow chord iterations which solve with the Jacobian and preconditioner of the previous Newton iteration");
+            EWOMS_REGISTER_PARAM(TypeTag, Scalar, ChordResidualReduction, "Largest ratio of consecutive residual norms for which chord iterations are continued");
+            EWOMS_REGISTER_PARAM(TypeTag, Scalar, ChordMaxRelativeChange, "Largest relative change of the solution over the time step for which chord iterations are used");
+            EWOMS_REGISTER_PARAM(TypeTag, int, SolutionPredictorOrder, "Order of the extrapolation of the primary variables and the well state from the previous time steps to the first Newton iterate (0: off, 1: linear, 2: quadratic)");
+            EWOMS_REGISTER_PARAM(TypeTag, bool, GasLiftGroupAllocation, "Allocate the lift gas increments of all gas lifted wells in the order of their incremental gradients, subject to the lift gas limits of the groups, instead of optimizing each well on its own");
         }
     };
 } // namespace Opm
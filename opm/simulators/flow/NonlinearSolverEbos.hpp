@@ -31,9 +31,14 @@
 #include <opm/models/utils/basicproperties.hh>
 #include <opm/common/Exceptions.hpp>
 
+#include <dune/common/dynmatrix.hh>
+#include <dune/common/dynvector.hh>
 #include <dune/common/fmatrix.hh>
 #include <dune/istl/bcrsmatrix.hh>
+#include <cmath>
+#include <deque>
 #include <memory>
+#include <vector>
 
 namespace Opm::Properties {
 
@@ -57,6 +62,18 @@ template<class TypeTag, class MyTypeTag>
 struct NewtonRelaxationType{
     using type = UndefinedProperty;
 };
+template<class TypeTag, class MyTypeTag>
+struct NewtonUpdateAcceleration{
+    using type = UndefinedProperty;
+};
+template<class TypeTag, class MyTypeTag>
+struct AndersonDepth{
+    using type = UndefinedProperty;
+};
+template<class TypeTag, class MyTypeTag>
+struct LineSearchMaxBacktracks{
+    using type = UndefinedProperty;
+};
 
 template<class TypeTag>
 struct NewtonMaxRelax<TypeTag, TTag::FlowNonLinearSolver> {
@@ -75,6 +92,18 @@ template<class TypeTag>
 struct NewtonRelaxationType<TypeTag, TTag::FlowNonLinearSolver> {
     static constexpr auto value = "dampen";
 };
+template<class TypeTag>
+struct NewtonUpdateAcceleration<TypeTag, TTag::FlowNonLinearSolver> {
+    static constexpr auto value = "none";
+};
+template<class TypeTag>
+struct AndersonDepth<TypeTag, TTag::FlowNonLinearSolver> {
+    static constexpr int value = 3;
+};
+template<class TypeTag>
+struct LineSearchMaxBacktracks<TypeTag, TTag::FlowNonLinearSolver> {
+    static constexpr int value = 3;
+};
 
 } // namespace Opm::Properties
 
@@ -95,6 +124,13 @@ namespace Opm {
             SOR
         };
 
+        // Available acceleration schemes for the Newton update.
+        enum AccelerationType {
+            NoAcceleration,
+            Anderson,
+            LineSearch
+        };
+
         // Solver parameters controlling nonlinear process.
         struct SolverParameters
         {
@@ -104,6 +140,9 @@ namespace Opm {
             double relaxRelTol_;
             int maxIter_; // max nonlinear iterations
             int minIter_; // min nonlinear iterations
+            AccelerationType accelerationType_;
+            int andersonDepth_; // number of previous updates used by Anderson acceleration
+            int lineSearchMaxBacktracks_; // max halvings of an update by the line search
 
             SolverParameters()
             {
@@ -123,6 +162,19 @@ namespace Opm {
                 } else {
                     OPM_THROW(std::runtime_error, "Unknown Relaxtion Type " << relaxationTypeString);
                 }
+
+                const auto& accelerationTypeString = EWOMS_GET_PARAM(TypeTag, std::string, NewtonUpdateAcceleration);
+                if (accelerationTypeString == "none") {
+                    accelerationType_ = NoAcceleration;
+                } else if (accelerationTypeString == "anderson") {
+                    accelerationType_ = Anderson;
+                } else if (accelerationTypeString == "linesearch") {
+                    accelerationType_ = LineSearch;
+                } else {
+                    OPM_THROW(std::runtime_error, "Unknown Newton update acceleration " << accelerationTypeString);
+                }
+                andersonDepth_ = EWOMS_GET_PARAM(TypeTag, int, AndersonDepth);
+                lineSearchMaxBacktracks_ = EWOMS_GET_PARAM(TypeTag, int, LineSearchMaxBacktracks);
             }
 
             static void registerParameters()
@@ -131,6 +183,9 @@ namespace Opm {
                 EWOMS_REGISTER_PARAM(TypeTag, int, FlowNewtonMaxIterations, "The maximum number of Newton iterations per time step used by flow");
                 EWOMS_REGISTER_PARAM(TypeTag, int, FlowNewtonMinIterations, "The minimum number of Newton iterations per time step used by flow");
                 EWOMS_REGISTER_PARAM(TypeTag, std::string, NewtonRelaxationType, "The type of relaxation used by flow's Newton method");
+                EWOMS_REGISTER_PARAM(TypeTag, std::string, NewtonUpdateAcceleration, "Acceleration of flow's Newton updates. Valid choices are none, anderson (Anderson acceleration) or linesearch (residual-based backtracking line search)");
+                EWOMS_REGISTER_PARAM(TypeTag, int, AndersonDepth, "The number of previous Newton updates used by Anderson acceleration");
+                EWOMS_REGISTER_PARAM(TypeTag, int, LineSearchMaxBacktracks, "The maximum number of times a Newton update is halved by the line search");
             }
 
             void reset()
@@ -142,12 +197,16 @@ namespace Opm {
                 relaxRelTol_ = 0.2;
                 maxIter_ = 10;
                 minIter_ = 1;
+                accelerationType_ = NoAcceleration;
+                andersonDepth_ = 3;
+                lineSearchMaxBacktracks_ = 3;
             }
 
         };
 
         // Forwarding types from PhysicalModel.
         typedef typename PhysicalModel::WellState WellState;
+        typedef typename PhysicalModel::BVector BVector;
 
         // ---------  Public methods  ---------
 
@@ -187,6 +246,9 @@ namespace Opm {
 
             int iteration = 0;
 
+            // Anderson acceleration only uses the updates of the current time step.
+            resetAcceleration();
+
             // Let the model do one nonlinear iteration.
 
             // Set up for main solver loop.
@@ -349,6 +411,98 @@ namespace Opm {
             return;
         }
 
+        /// Replace the Newton update dx by the Anderson-accelerated update
+        /// computed from the updates of the previous iterations of this time
+        /// step. The Newton updates are interpreted as residuals of the
+        /// fixed-point map x -> x + dx, and the accelerated update is
+        /// dx - (dX + dF) gamma, where gamma minimizes |dx - dF gamma| and the
+        /// columns of dF and dX are the differences of consecutive Newton
+        /// updates and the updates applied in the previous iterations. The
+        /// inner products are summed over \p interiorCells on all processes,
+        /// so that each cell is counted once. The caller should report the
+        /// update which was actually applied with setAppliedUpdate().
+        template <class Communication>
+        void andersonAccelerate(BVector& dx, const std::vector<int>& interiorCells, const Communication& comm)
+        {
+            if (haveLastUpdate_) {
+                BVector updateChange = dx;
+                updateChange -= lastNewtonUpdate_;
+                andersonUpdateChanges_.push_back(std::move(updateChange));
+                andersonSteps_.push_back(lastAppliedUpdate_);
+                while (static_cast<int>(andersonUpdateChanges_.size()) > param_.andersonDepth_) {
+                    andersonUpdateChanges_.pop_front();
+                    andersonSteps_.pop_front();
+                }
+            }
+            lastNewtonUpdate_ = dx;
+            haveLastUpdate_ = true;
+
+            const int depth = andersonUpdateChanges_.size();
+            if (depth > 0) {
+                // normal equations of the least squares problem, reduced over all processes
+                std::vector<double> products(depth*(depth + 1), 0.0);
+                for (int i = 0; i < depth; ++i) {
+                    for (int j = 0; j <= i; ++j) {
+                        products[i*depth + j] = interiorDot_(andersonUpdateChanges_[i], andersonUpdateChanges_[j], interiorCells);
+                    }
+                    products[depth*depth + i] = interiorDot_(andersonUpdateChanges_[i], dx, interiorCells);
+                }
+                comm.sum(products.data(), products.size());
+
+                Dune::DynamicMatrix<double> normalMatrix(depth, depth, 0.0);
+                Dune::DynamicVector<double> rhs(depth, 0.0);
+                double trace = 0.0;
+                for (int i = 0; i < depth; ++i) {
+                    for (int j = 0; j <= i; ++j) {
+                        normalMatrix[i][j] = products[i*depth + j];
+                        normalMatrix[j][i] = products[i*depth + j];
+                    }
+                    rhs[i] = products[depth*depth + i];
+                    trace += normalMatrix[i][i];
+                }
+
+                if (trace > 0.0 && std::isfinite(trace)) {
+                    // small Tikhonov regularization, since consecutive updates are often almost parallel
+                    for (int i = 0; i < depth; ++i) {
+                        normalMatrix[i][i] += 1e-10 * trace;
+                    }
+                    Dune::DynamicVector<double> gamma(depth, 0.0);
+                    try {
+                        normalMatrix.solve(gamma, rhs);
+                        for (int i = 0; i < depth; ++i) {
+                            dx.axpy(-gamma[i], andersonSteps_[i]);
+                            dx.axpy(-gamma[i], andersonUpdateChanges_[i]);
+                        }
+                    }
+                    catch (const Dune::FMatrixError&) {
+                        // singular system: use the plain Newton update
+                    }
+                }
+            }
+            lastAppliedUpdate_ = dx;
+        }
+
+        /// Replace the last update of andersonAccelerate() by the update
+        /// that was applied to the solution, i.e. after the chopping.
+        void setAppliedUpdate(const BVector& dx)
+        { lastAppliedUpdate_ = dx; }
+
+        /// Forget the updates used by Anderson acceleration.
+        void resetAcceleration()
+        {
+            andersonUpdateChanges_.clear();
+            andersonSteps_.clear();
+            haveLastUpdate_ = false;
+        }
+
+        /// The acceleration scheme applied to the Newton updates.
+        AccelerationType accelerationType() const
+        { return param_.accelerationType_; }
+
+        /// The maximum number of times an update is halved by the line search.
+        int lineSearchMaxBacktracks() const
+        { return param_.lineSearchMaxBacktracks_; }
+
         /// The greatest relaxation factor (i.e. smallest factor) allowed.
         double relaxMax() const
         { return param_.relaxMax_; }
@@ -378,6 +532,15 @@ namespace Opm {
         { param_ = param; }
 
     private:
+        static double interiorDot_(const BVector& a, const BVector& b, const std::vector<int>& cells)
+        {
+            double result = 0.0;
+            for (const int cell : cells) {
+                result += a[cell] * b[cell];
+            }
+            return result;
+        }
+
         // ---------  Data members  ---------
         SimulatorReportSingle failureReport_;
         SolverParameters param_;
@@ -389,6 +552,13 @@ namespace Opm {
         int nonlinearIterationsLast_;
         int linearIterationsLast_;
         int wellIterationsLast_;
+
+        // state of the Anderson acceleration
+        std::deque<BVector> andersonUpdateChanges_;
+        std::deque<BVector> andersonSteps_;
+        BVector lastNewtonUpdate_;
+        BVector lastAppliedUpdate_;
+        bool haveLastUpdate_ = false;
     };
 } // namespace Opm
 
@@ -0,0 +1,130 @@
+/*
+  Copyright 2021 Equinor ASA.
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <config.h>
+
+#include <opm/simulators/flow/partitionCells.hpp>
+
+#include <algorithm>
+#include <queue>
+#include <set>
+#include <stdexcept>
+
+namespace Opm
+{
+
+    std::pair<std::vector<int>, int>
+    partitionCellsBreadthFirst(const std::vector<std::vector<int>>& neighbours,
+                               const int num_domains)
+    {
+        if (num_domains < 1) {
+            throw std::invalid_argument("partitionCellsBreadthFirst: number of domains must be positive");
+        }
+
+        const int num_cells = neighbours.size();
+        const int target_size = (num_cells + num_domains - 1) / num_domains;
+        const int min_size = std::max(target_size / 10, 1);
+
+        std::vector<int> partition(num_cells, -1);
+        std::vector<int> domain_cells;
+        std::queue<int> front;
+        int num_created = 0;
+
+        for (int seed = 0; seed < num_cells; ++seed) {
+            if (partition[seed] >= 0) {
+                continue;
+            }
+
+            const int domain = num_created;
+            domain_cells.clear();
+            partition[seed] = domain;
+            domain_cells.push_back(seed);
+            front.push(seed);
+            int merge_candidate = -1;
+
+            while (!front.empty()) {
+                const int cell = front.front();
+                front.pop();
+                for (const int nb : neighbours[cell]) {
+                    if (partition[nb] >= 0) {
+                        if (partition[nb] != domain) {
+                            merge_candidate = partition[nb];
+                        }
+                        continue;
+                    }
+                    if (static_cast<int>(domain_cells.size()) < target_size) {
+                        partition[nb] = domain;
+                        domain_cells.push_back(nb);
+                        front.push(nb);
+                    }
+                }
+            }
+
+            // a small fragment which is enclosed by already existing domains
+            // is not worth a domain of its own.
+            if (static_cast<int>(domain_cells.size()) < min_size && merge_candidate >= 0) {
+                for (const int cell : domain_cells) {
+                    partition[cell] = merge_candidate;
+                }
+            }
+            else {
+                ++num_created;
+            }
+        }
+
+        return { partition, num_created };
+    }
+
+
+
+    std::pair<std::vector<int>, int>
+    colorDomains(const std::vector<std::vector<int>>& neighbours,
+                 const std::vector<int>& partition,
+                 const int num_domains)
+    {
+        std::vector<std::set<int>> domain_neighbours(num_domains);
+        const int num_cells = neighbours.size();
+        for (int cell = 0; cell < num_cells; ++cell) {
+            for (const int nb : neighbours[cell]) {
+                if (partition[nb] != partition[cell]) {
+                    domain_neighbours[partition[cell]].insert(partition[nb]);
+                }
+            }
+        }
+
+        // greedy coloring in the order of the domains
+        std::vector<int> colors(num_domains, -1);
+        std::vector<char> used;
+        int num_colors = 0;
+        for (int domain = 0; domain < num_domains; ++domain) {
+            used.assign(num_colors + 1, 0);
+            for (const int nb : domain_neighbours[domain]) {
+                if (colors[nb] >= 0) {
+                    used[colors[nb]] = 1;
+                }
+            }
+            const int color = std::find(used.begin(), used.end(), 0) - used.begin();
+            colors[domain] = color;
+            num_colors = std::max(num_colors, color + 1);
+        }
+
+        return { colors, num_colors };
+    }
+
+} // namespace Opm
@@ -0,0 +1,63 @@
+/*
+  Copyright 2021 Equinor ASA.
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef OPM_PARTITIONCELLS_HEADER_INCLUDED
+#define OPM_PARTITIONCELLS_HEADER_INCLUDED
+
+#include <utility>
+#include <vector>
+
+namespace Opm
+{
+
+    /// Partition the cells of a grid into connected domains of roughly
+    /// equal size.
+    ///
+    /// Domains are grown breadth first from the unassigned cell with the
+    /// lowest index until they reach the target size. Fragments much
+    /// smaller than the target size which are enclosed by other domains
+    /// are merged into one of their neighbouring domains.
+    ///
+    /// \param[in] neighbours   Adjacency lists of the cells, e.g. the sparsity
+    ///                         pattern of the Jacobian. A cell may list itself.
+    /// \param[in] num_domains  Requested number of domains (at least one).
+    /// \return A pair of the domain index of each cell and the number of
+    ///         domains actually created.
+    std::pair<std::vector<int>, int>
+    partitionCellsBreadthFirst(const std::vector<std::vector<int>>& neighbours,
+                               const int num_domains);
+
+    /// Color the domains of a partition such that neighbouring domains get
+    /// different colors.
+    ///
+    /// Domains of the same color do not share any cell face and can hence
+    /// be processed concurrently.
+    ///
+    /// \param[in] neighbours   Adjacency lists of the cells.
+    /// \param[in] partition    Domain index of each cell.
+    /// \param[in] num_domains  Number of domains in the partition.
+    /// \return A pair of the color of each domain and the number of colors.
+    std::pair<std::vector<int>, int>
+    colorDomains(const std::vector<std::vector<int>>& neighbours,
+                 const std::vector<int>& partition,
+                 const int num_domains);
+
+} // namespace Opm
+
+#endif // OPM_PARTITIONCELLS_HEADER_INCLUDED
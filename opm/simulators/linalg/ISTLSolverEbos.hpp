@@ -126,6 +126,7 @@ namespace Opm
 #endif
             parameters_.template init<TypeTag>();
             prm_ = setupPropertyTree<TypeTag>(parameters_);
+            reduction_ = prm_.get<double>("tol", parameters_.linear_solver_reduction_);
 #if HAVE_CUDA || HAVE_OPENCL
             {
                 std::string gpu_mode = EWOMS_GET_PARAM(TypeTag, std::string, GpuMode);
@@ -217,6 +218,14 @@ namespace Opm
         }
 
 
+        /// Prepare a solve with a new right hand side, reusing the matrix
+        /// and the preconditioner set up by the last call to prepare().
+        void prepareReusingSetup(Vector& b)
+        {
+            assert(flexibleSolver_);
+            rhs_ = &b;
+        }
+
         void setResidual(Vector& /* b */) {
             // rhs_ = &b; // Must be handled in prepare() instead.
         }
@@ -229,6 +238,11 @@ namespace Opm
             // matrix_ = &M.istlMatrix(); // Must be handled in prepare() instead.
         }
 
+        /// Set the residual reduction required by the following solves.
+        void setReduction(const double reduction) {
+            reduction_ = reduction;
+        }
+
         bool solve(Vector& x) {
             // Write linear system if asked for.
             const int verbosity = prm_.get<int>("verbosity", 0);
@@ -283,7 +297,7 @@ namespace Opm
             // Otherwise, use flexible istl solver.
             if (!gpu_was_used) {
                 assert(flexibleSolver_);
-                flexibleSolver_->apply(x, *rhs_, result);
+                flexibleSolver_->apply(x, *rhs_, reduction_, result);
             }
 
             // Check convergence, iterations etc.
@@ -509,6 +523,7 @@ namespace Opm
 
         FlowLinearSolverParameters parameters_;
         boost::property_tree::ptree prm_;
+        double reduction_;
         bool scale_variables_;
 
         std::shared_ptr< CommunicationType > comm_;
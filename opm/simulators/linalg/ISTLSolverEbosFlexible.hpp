@@ -100,6 +100,7 @@ public:
     {
         parameters_.template init<TypeTag>();
         prm_ = setupPropertyTree<TypeTag>(parameters_);
+        reduction_ = prm_.get<double>("tol", parameters_.linear_solver_reduction_);
         extractParallelGridInformationToISTL(simulator_.vanguard().grid(), parallelInformation_);
         // For some reason simulator_.model().elementMapper() is not initialized at this stage
         // Hence const auto& elemMapper = simulator_.model().elementMapper(); does not work.
@@ -196,9 +197,17 @@ public:
         }
     }
 
+    /// Prepare a solve with a new right hand side, reusing the matrix
+    /// and the preconditioner set up by the last call to prepare().
+    void prepareReusingSetup(VectorType& b)
+    {
+        assert(solver_);
+        rhs_ = b;
+    }
+
     bool solve(VectorType& x)
     {
-        solver_->apply(x, rhs_, res_);
+        solver_->apply(x, rhs_, reduction_, res_);
         this->writeMatrix();
         return res_.converged;
     }
@@ -227,6 +236,12 @@ public:
         // matrix_ = &M.istlMatrix(); // Must be handled in prepare() instead.
     }
 
+    /// Set the residual reduction required by the following solves.
+    void setReduction(const double reduction)
+    {
+        reduction_ = reduction;
+    }
+
 protected:
 
     bool shouldCreateSolver() const
@@ -338,6 +353,7 @@ protected:
     std::unique_ptr<SolverType> solver_;
     FlowLinearSolverParameters parameters_;
     boost::property_tree::ptree prm_;
+    double reduction_;
     VectorType rhs_;
     Dune::InverseOperatorResult res_;
     std::any parallelInformation_;
@@ -42,10 +42,14 @@ namespace Opm
           linear_solve_time(0.0),
           update_time(0.0),
           output_write_time(0.0),
+          local_solve_time(0.0),
           total_well_iterations(0),
           total_linearizations( 0 ),
           total_newton_iterations( 0 ),
           total_linear_iterations( 0 ),
+          total_local_newton_iterations( 0 ),
+          well_operability_cache_hits( 0 ),
+          well_operability_cache_misses( 0 ),
           converged(false),
           exit_status(EXIT_SUCCESS),
           global_time(0),
@@ -65,11 +69,15 @@ namespace Opm
         assemble_time_well += sr.assemble_time_well;
         update_time += sr.update_time;
         output_write_time += sr.output_write_time;
+        local_solve_time += sr.local_solve_time;
         total_time += sr.total_time;
         total_well_iterations += sr.total_well_iterations;
         total_linearizations += sr.total_linearizations;
         total_newton_iterations += sr.total_newton_iterations;
         total_linear_iterations += sr.total_linear_iterations;
+        total_local_newton_iterations += sr.total_local_newton_iterations;
+        well_operability_cache_hits += sr.well_operability_cache_hits;
+        well_operability_cache_misses += sr.well_operability_cache_misses;
         global_time = sr.global_time; // It makes no sense adding time points, so = not += here.
     }
 
@@ -85,6 +93,11 @@ namespace Opm
                           assemble_time,
                           total_linear_iterations,
                           linear_solve_time);
+        if (total_local_newton_iterations != 0) {
+            ss << fmt::format(", local Newton its={:3} ({:2.1f}sec)",
+                              total_local_newton_iterations,
+                              local_solve_time);
+        }
     }
 
     void SimulatorReportSingle::reportFullyImplicit(std::ostream& os, const SimulatorReportSingle* failureReport) const
@@ -154,6 +167,17 @@ namespace Opm
                               output_write_time + (failureReport ? failureReport->output_write_time : 0.0));
             os << std::endl;
 
+            t = local_solve_time + (failureReport ? failureReport->local_solve_time : 0.0);
+            if (t > 0.0) {
+                os << fmt::format(" Local solve time (seconds):  {:7.2f}", t);
+                if (failureReport) {
+                  os << fmt::format(" (Failed: {:2.1f}; {:2.1f}%)",
+                                    failureReport->local_solve_time,
+                                    100*failureReport->local_solve_time/t);
+                }
+                os << std::endl;
+            }
+
         }
 
         int n = total_linearizations + (failureReport ? failureReport->total_linearizations : 0);
@@ -182,6 +206,27 @@ namespace Opm
                             100.0*failureReport->total_linear_iterations/n);
         }
         os << std::endl;
+
+        n = total_local_newton_iterations + (failureReport ? failureReport->total_local_newton_iterations : 0);
+        if (n > 0) {
+            os << fmt::format("Overall Local Newton Its:  {:7}", n);
+            if (failureReport) {
+              os << fmt::format("    (Failed: {:3}; {:2.1f}%)",
+                                failureReport->total_local_newton_iterations,
+                                100.0*failureReport->total_local_newton_iterations/n);
+            }
+            os << std::endl;
+        }
+
+        n = well_operability_cache_hits + well_operability_cache_misses
+            + (failureReport ? failureReport->well_operability_cache_hits
+                               + failureReport->well_operability_cache_misses : 0);
+        if (n > 0) {
+            const int hits = well_operability_cache_hits + (failureReport ? failureReport->well_operability_cache_hits : 0);
+            os << fmt::format("Well Operability Checks:   {:7}    (Reused: {:3}; {:2.1f}%)",
+                              n, hits, 100.0*hits/n);
+            os << std::endl;
+        }
     }
 
     void SimulatorReport::operator+=(const SimulatorReportSingle& sr)
@@ -40,11 +40,15 @@ namespace Opm
         double linear_solve_time;
         double update_time;
         double output_write_time;
+        double local_solve_time;
 
         unsigned int total_well_iterations;
         unsigned int total_linearizations;
         unsigned int total_newton_iterations;
         unsigned int total_linear_iterations;
+        unsigned int total_local_newton_iterations;
+        unsigned int well_operability_cache_hits;
+        unsigned int well_operability_cache_misses;
 
         bool converged;
         int exit_status;
@@ -38,6 +38,7 @@
 #include <string>
 #include <tuple>
 #include <unordered_map>
+#include <utility>
 #include <vector>
 
 #include <stddef.h>
@@ -51,6 +52,7 @@
 #include <opm/parser/eclipse/EclipseState/Schedule/Group/GConSale.hpp>
 
 #include <opm/simulators/timestepping/SimulatorReport.hpp>
+#include <opm/simulators/wells/GroupTree.hpp>
 #include <opm/simulators/wells/PerforationData.hpp>
 #include <opm/simulators/wells/VFPInjProperties.hpp>
 #include <opm/simulators/wells/VFPProdProperties.hpp>
@@ -101,6 +103,7 @@ namespace Opm {
             using RateVector = GetPropType<TypeTag, Properties::RateVector>;
             using GlobalEqVector = GetPropType<TypeTag, Properties::GlobalEqVector>;
             using SparseMatrixAdapter = GetPropType<TypeTag, Properties::SparseMatrixAdapter>;
+            using ThreadManager = GetPropType<TypeTag, Properties::ThreadManager>;
 
             typedef typename Opm::BaseAuxiliaryModule<TypeTag>::NeighborSet NeighborSet;
 
@@ -241,6 +244,15 @@ namespace Opm {
             // Check if well equations is converged.
             ConvergenceReport getWellConvergence(const std::vector<Scalar>& B_avg, const bool checkGroupConvergence = false) const;
 
+            // Largest mass balance residual of the operable wells on all
+            // processes, relative to the well tolerance.
+            double relativeWellResidual(const std::vector<Scalar>& B_avg) const;
+
+            // Replace the well state by the given one, e.g. the state before
+            // a rejected Newton update, and solve the well equations for the
+            // current reservoir state.
+            void resetAndSolveWells(const WellState& well_state);
+
             // return the internal well state, ignore the passed one.
             // Used by the legacy code to make it compatible with the legacy well models.
             const WellState& wellState(const WellState& well_state OPM_UNUSED) const;
@@ -248,8 +260,21 @@ namespace Opm {
             // return the internal well state
             const WellState& wellState() const;
 
+            // Replace the BHPs and surface rates of the current well state by
+            // the linear combination of the given well states, e.g. to
+            // extrapolate from the previous time steps. A well is left
+            // unchanged if it is not present with the same controls in all
+            // of the given states or if a predicted rate changes its sign.
+            void predictWellState(const std::vector<const WellState*>& wellStates,
+                                  const std::vector<double>& coefficients);
+
             const SimulatorReportSingle& lastReport() const;
 
+            // add the operability cache statistics of the wells since the
+            // last call to the report, including those of the wells of
+            // earlier time steps that were not added yet.
+            void addOperabilityCacheStatistics(SimulatorReportSingle& report);
+
             void addWellContributions(SparseMatrixAdapter& jacobian) const
             {
                 for ( const auto& well: well_container_ ) {
@@ -278,6 +303,8 @@ namespace Opm {
             std::vector< ParallelWellInfo* > local_parallel_well_info_;
 
             bool wells_active_;
+            // whether any process has a well which is distributed over several processes
+            bool any_distributed_wells_ = false;
 
             // a vector of all the wells.
             std::vector<WellInterfacePtr > well_container_;
@@ -289,6 +316,23 @@ namespace Opm {
 
             std::vector<bool> is_cell_perforated_;
 
+            // the perforations of the local cells as pairs of an index into
+            // well_container_ and a perforation index of that well.  The
+            // perforations of cell c are the entries from
+            // cell_perforations_offset_[c] to cell_perforations_offset_[c + 1].
+            std::vector<int> cell_perforations_offset_;
+            std::vector<std::pair<int, int>> cell_perforations_;
+
+            // indices into well_container_ by well name.
+            std::unordered_map<std::string, int> well_container_index_;
+
+            // indices into well_container_ of the wells not shared with other
+            // processes, grouped such that wells of the same color do not
+            // perforate the same cell.
+            std::vector<std::vector<int>> wells_by_color_;
+            // indices into well_container_ of the distributed wells.
+            std::vector<int> distributed_wells_;
+
             std::function<bool(const Well&)> is_shut_or_defunct_;
 
             void initializeWellProdIndCalculators();
@@ -309,11 +353,20 @@ namespace Opm {
             createTypedWellPointer(const int wellID,
                                    const int time_step) const;
 
+            // A copy of the well state with the layout of well_state_ in which the
+            // wells do their trial solutions. Each well only touches its own
+            // entries and resets them from the well state before use, so the
+            // copy is only made once per report step and shared by all wells.
+            WellState& scratchWellState();
+
             WellInterfacePtr createWellForWellTest(const std::string& well_name, const int report_step, Opm::DeferredLogger& deferred_logger) const;
 
             WellState well_state_;
             WellState previous_well_state_;
             WellState well_state_nupcol_;
+            // well state lent to the wells for their trial solutions, see
+            // scratchWellState()
+            std::optional<WellState> scratch_well_state_;
 
             const ModelParameters param_;
             bool terminal_output_;
@@ -332,12 +385,20 @@ namespace Opm {
             std::optional<int> last_run_wellpi_{};
 
             std::unique_ptr<RateConverterType> rateConverter_;
+            // whether the state of the rate converter is that of the
+            // current reservoir state, i.e. no time step since it was defined
+            bool rate_converter_state_current_ = false;
             std::unique_ptr<VFPProperties> vfp_properties_;
 
             SimulatorReportSingle last_report_;
+            // operability cache statistics of wells that are no longer in
+            // well_container_, not yet added to a report
+            SimulatorReportSingle pending_operability_cache_statistics_;
 
             WellTestState wellTestState_;
             std::unique_ptr<GuideRate> guideRate_;
+            // group hierarchy of the current report step
+            GroupTree group_tree_;
 
             std::map<std::string, double> node_pressures_; // Storing network pressures for output.
 
@@ -386,7 +447,7 @@ namespace Opm {
             void updateWellControls(Opm::DeferredLogger& deferred_logger, const bool checkGroupControls);
 
             void updateAndCommunicateGroupData();
-            void updateNetworkPressures();
+            void updateNetworkPressures(Opm::DeferredLogger& deferred_logger);
 
             // setting the well_solutions_ based on well_state.
             void updatePrimaryVariables(Opm::DeferredLogger& deferred_logger);
@@ -398,6 +459,17 @@ namespace Opm {
 
             void computeAverageFormationFactor(std::vector<Scalar>& B_avg) const;
 
+            // update is_cell_perforated_ and the perforation and name lookup
+            // tables for the wells of well_container_.
+            void updatePerforatedCells();
+
+            // color the wells by their perforated cells for the concurrent apply.
+            void computeWellColors();
+
+            // call f(well) for all wells, concurrently for wells of the same color.
+            template <class Function>
+            void forEachWellByColor(Function&& f) const;
+
             // Calculating well potentials for each well
             void computeWellPotentials(std::vector<double>& well_potentials, const int reportStepIdx, Opm::DeferredLogger& deferred_logger);
 
@@ -425,6 +497,21 @@ namespace Opm {
 
             void assembleWellEq(const std::vector<Scalar>& B_avg, const double dt, Opm::DeferredLogger& deferred_logger);
 
+            // call f(w, deferred_logger) for the wells of well_container_,
+            // concurrently for the wells that are not shared with other
+            // processes, each thread with its own logger, starting with the
+            // wells of the largest solveCostEstimate(). The distributed wells
+            // are visited afterwards in the same order on all processes.
+            template <class Function>
+            void forEachWellConcurrently(Function&& f, Opm::DeferredLogger& deferred_logger);
+
+            // optimize the lift gas of the wells before their assembly.
+            void gasLiftOptimizationStage(Opm::DeferredLogger& deferred_logger);
+
+            // allocate lift gas increments over all wells by their incremental
+            // gradients, within the lift gas limits of the groups.
+            void allocateLiftGas(Opm::DeferredLogger& deferred_logger);
+
             // some preparation work, mostly related to group control and RESV,
             // at the beginning of each time step (Not report step)
             void prepareTimeStep(Opm::DeferredLogger& deferred_logger);
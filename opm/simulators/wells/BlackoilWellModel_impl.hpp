@@ -26,6 +26,10 @@
 #include <opm/parser/eclipse/Units/UnitSystem.hpp>
 
 #include <algorithm>
+#include <array>
+#include <exception>
+#include <limits>
+#include <numeric>
 #include <utility>
 #include <fmt/format.h>
 
@@ -266,10 +270,19 @@ namespace Opm {
         wells_active_ = localWellsActive() ? 1 : 0;
         wells_active_ = grid.comm().max(wells_active_);
 
+        // The connection pressures of distributed wells are exchanged for all
+        // of them together, see calculateExplicitQuantities().
+        const bool local_distributed_wells =
+            std::any_of(local_parallel_well_info_.begin(), local_parallel_well_info_.end(),
+                        [](const ParallelWellInfo* info) { return info->communication().size() > 1; });
+        any_distributed_wells_ = grid.comm().max(local_distributed_wells ? 1 : 0);
+
         // handling MS well related
         if (param_.use_multisegment_well_&& anyMSWellOpenLocal()) { // if we use MultisegmentWell model
             well_state_.initWellStateMSWell(wells_ecl_, phase_usage_, &previous_well_state_);
         }
+        // the layout of the well state may have changed
+        scratch_well_state_.reset();
 
         const int nw = wells_ecl_.size();
         for (int w = 0; w <nw; ++w) {
@@ -294,10 +307,21 @@ namespace Opm {
         const Group& fieldGroup = schedule().getGroup("FIELD", timeStepIdx);
         WellGroupHelpers::setCmodeGroup(fieldGroup, schedule(), summaryState, timeStepIdx, well_state_);
 
-        // Compute reservoir volumes for RESV controls.
-        rateConverter_.reset(new RateConverterType (phase_usage_,
-                                                    std::vector<int>(local_num_cells_, 0)));
-        rateConverter_->template defineState<ElementContext>(ebosSimulator_);
+        // The group hierarchy is fixed within the report step, and so are
+        // the indices of the groups and wells in the well state.
+        group_tree_ = GroupTree(schedule(), timeStepIdx);
+        group_tree_.resolveStateIndices(well_state_);
+
+        // Compute reservoir volumes for RESV controls. The state is already
+        // defined at the end of the last time step of the previous report step.
+        if (!rateConverter_) {
+            rateConverter_.reset(new RateConverterType (phase_usage_,
+                                                        std::vector<int>(local_num_cells_, 0)));
+        }
+        if (!rate_converter_state_current_) {
+            rateConverter_->template defineState<ElementContext>(ebosSimulator_);
+            rate_converter_state_current_ = true;
+        }
 
         {
             const auto& sched_state = this->schedule()[timeStepIdx];
@@ -322,6 +346,9 @@ namespace Opm {
 
         updatePerforationIntensiveQuantities();
 
+        // The reservoir state changes in the time step, also if it fails.
+        rate_converter_state_current_ = false;
+
         Opm::DeferredLogger local_deferredLogger;
 
         well_state_ = previous_well_state_;
@@ -335,6 +362,10 @@ namespace Opm {
             wellTesting(reportStepIdx, simulationTime, local_deferredLogger);
 
             // create the well container
+            // keep the statistics of the checks done after the last report
+            for (auto& well : well_container_) {
+                well->addOperabilityCacheStatistics(pending_operability_cache_statistics_);
+            }
             well_container_ = createWellContainer(reportStepIdx);
 
             // do the initialization for all the wells
@@ -348,10 +379,9 @@ namespace Opm {
             }
 
             // update the updated cell flag
-            std::fill(is_cell_perforated_.begin(), is_cell_perforated_.end(), false);
-            for (auto& well : well_container_) {
-                well->updatePerforatedCell(is_cell_perforated_);
-            }
+            updatePerforatedCells();
+
+            computeWellColors();
 
             // calculate the efficiency factors for each well
             calculateEfficiencyFactors(reportStepIdx);
@@ -401,7 +431,7 @@ namespace Opm {
 
         //compute well guideRates
         const auto& comm = ebosSimulator_.vanguard().grid().comm();
-        WellGroupHelpers::updateGuideRatesForWells(schedule(), phase_usage_, reportStepIdx, simulationTime, well_state_, comm, guideRate_.get());
+        WellGroupHelpers::updateGuideRatesForWells(group_tree_, phase_usage_, reportStepIdx, simulationTime, well_state_, comm, guideRate_.get());
         try {
             updateAndCommunicateGroupData();
             // Compute initial well solution for new wells
@@ -465,16 +495,18 @@ namespace Opm {
                 // some preparation before the well can be used
                 well->init(&phase_usage_, depth_, gravity_, local_num_cells_, B_avg);
                 const Well& wellEcl = schedule().getWell(well_name, timeStepIdx);
-                double well_efficiency_factor = wellEcl.getEfficiencyFactor();
-                WellGroupHelpers::accumulateGroupEfficiencyFactor(schedule().getGroup(wellEcl.groupName(), timeStepIdx), schedule(), timeStepIdx, well_efficiency_factor);
+                const double well_efficiency_factor = wellEcl.getEfficiencyFactor()
+                    * group_tree_.accumulatedEfficiencyFactor(wellEcl.groupName());
                 well->setWellEfficiencyFactor(well_efficiency_factor);
                 well->setVFPProperties(vfp_properties_.get());
                 well->setGuideRate(guideRate_.get());
 
                 const WellTestConfig::Reason testing_reason = testWell.second;
 
+                well->setScratchWellState(&scratchWellState());
                 well->wellTesting(ebosSimulator_, B_avg, simulationTime, timeStepIdx,
                                   testing_reason, well_state_, wellTestState_, deferred_logger);
+                well->setScratchWellState(nullptr);
             }
         }
     }
@@ -497,6 +529,19 @@ namespace Opm {
     BlackoilWellModel<TypeTag>::
     lastReport() const {return last_report_; }
 
+    template<typename TypeTag>
+    void
+    BlackoilWellModel<TypeTag>::
+    addOperabilityCacheStatistics(SimulatorReportSingle& report)
+    {
+        for (auto& well : well_container_) {
+            well->addOperabilityCacheStatistics(report);
+        }
+        report.well_operability_cache_hits += pending_operability_cache_statistics_.well_operability_cache_hits;
+        report.well_operability_cache_misses += pending_operability_cache_statistics_.well_operability_cache_misses;
+        pending_operability_cache_statistics_ = SimulatorReportSingle();
+    }
+
     // called at the end of a time step
     template<typename TypeTag>
     void
@@ -517,6 +562,7 @@ namespace Opm {
 
         // update the rate converter with current averages pressures etc in
         rateConverter_->template defineState<ElementContext>(ebosSimulator_);
+        rate_converter_state_current_ = true;
 
         // calculate the well potentials
         try {
@@ -558,8 +604,10 @@ namespace Opm {
         if (!is_cell_perforated_[elemIdx])
             return;
 
-        for (const auto& well : well_container_)
-            well->addCellRates(rate, elemIdx);
+        for (int i = cell_perforations_offset_[elemIdx]; i < cell_perforations_offset_[elemIdx + 1]; ++i) {
+            const auto& [well_idx, perf_idx] = cell_perforations_[i];
+            well_container_[well_idx]->addPerforationRates(rate, perf_idx);
+        }
     }
 
 
@@ -569,13 +617,12 @@ namespace Opm {
     BlackoilWellModel<TypeTag>::
     well(const std::string& wellName) const
     {
-        for (const auto& well : well_container_) {
-            if (well->name() == wellName) {
-                return well;
-            }
+        const auto it = well_container_index_.find(wellName);
+        if (it == well_container_index_.end()) {
+            OPM_THROW(std::invalid_argument, "The well with name " + wellName + " is not in the well Container");
         }
-        OPM_THROW(std::invalid_argument, "The well with name " + wellName + " is not in the well Container");
-        return nullptr;
+        assert(well_container_[it->second]->name() == wellName);
+        return well_container_[it->second];
     }
 
     template<typename TypeTag>
@@ -603,6 +650,7 @@ namespace Opm {
             const size_t numCells = Opm::UgGridHelpers::numCells(grid());
             const bool handle_ms_well = (param_.use_multisegment_well_ && anyMSWellOpenLocal());
             well_state_.resize(wells_ecl_, local_parallel_well_info_, schedule(), handle_ms_well, numCells, phaseUsage, well_perf_data_, summaryState, globalNumWells); // Resize for restart step
+            scratch_well_state_.reset();
             wellsToState(restartValues.wells, restartValues.grp_nwrk, phaseUsage, handle_ms_well, well_state_);
         }
 
@@ -989,6 +1037,8 @@ namespace Opm {
         }
         logAndCheckForExceptionsAndThrow(local_deferredLogger, exception_thrown, "assemble() failed.", terminal_output_);
 
+        addOperabilityCacheStatistics(last_report_);
+
         last_report_.converged = true;
         last_report_.assemble_time_well += perfTimer.stop();
     }
@@ -998,10 +1048,244 @@ namespace Opm {
     BlackoilWellModel<TypeTag>::
     assembleWellEq(const std::vector<Scalar>& B_avg, const double dt, Opm::DeferredLogger& deferred_logger)
     {
-        for (auto& well : well_container_) {
-            well->maybeDoGasLiftOptimization(
-                 well_state_, ebosSimulator_, deferred_logger);
-            well->assembleWellEq(ebosSimulator_, B_avg, dt, well_state_, deferred_logger);
+        // The lift gas of all wells is optimized before the assembly, as the
+        // allocation over the wells of a group needs all of them.
+        gasLiftOptimizationStage(deferred_logger);
+
+        // A well only writes its own entries of the well state, so the wells
+        // are assembled concurrently.
+        forEachWellConcurrently([this, &B_avg, dt](const int w, Opm::DeferredLogger& logger)
+                                {
+                                    well_container_[w]->assembleWellEq(ebosSimulator_, B_avg, dt, well_state_, logger);
+                                }, deferred_logger);
+    }
+
+    template<typename TypeTag>
+    template <class Function>
+    void
+    BlackoilWellModel<TypeTag>::
+    forEachWellConcurrently(Function&& f, Opm::DeferredLogger& deferred_logger)
+    {
+        // Distributed wells communicate, and are handled after the local
+        // wells in the same order on all processes.
+        std::vector<int> local_wells;
+        std::vector<int> distributed_wells;
+        local_wells.reserve(well_container_.size());
+        for (int w = 0; w < static_cast<int>(well_container_.size()); ++w) {
+            if (well_container_[w]->parallelWellInfo().communication().size() > 1) {
+                distributed_wells.push_back(w);
+            } else {
+                local_wells.push_back(w);
+            }
+        }
+
+        // The most expensive wells are started first, so that a few large
+        // wells are not left for the end while the other threads are idle.
+        const int num_threads = ThreadManager::maxThreads();
+        if (num_threads > 1) {
+            std::vector<double> cost(well_container_.size(), 0.0);
+            for (const int w : local_wells) {
+                cost[w] = well_container_[w]->solveCostEstimate();
+            }
+            std::stable_sort(local_wells.begin(), local_wells.end(),
+                             [&cost](const int w1, const int w2) { return cost[w1] > cost[w2]; });
+        }
+
+        std::vector<Opm::DeferredLogger> thread_loggers(num_threads);
+        std::vector<std::exception_ptr> thread_exceptions(num_threads);
+        const int num_local_wells = local_wells.size();
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic) num_threads(num_threads)
+#endif
+        for (int k = 0; k < num_local_wells; ++k) {
+            const int thread_id = ThreadManager::threadId();
+            if (thread_exceptions[thread_id]) {
+                continue;
+            }
+            try {
+                f(local_wells[k], thread_loggers[thread_id]);
+            } catch (...) {
+                thread_exceptions[thread_id] = std::current_exception();
+            }
+        }
+        for (const auto& logger : thread_loggers) {
+            deferred_logger.append(logger);
+        }
+
+        // the distributed wells are visited even if a local well failed to
+        // keep the communication consistent between the processes.
+        for (const int w : distributed_wells) {
+            f(w, deferred_logger);
+        }
+
+        for (const auto& exception : thread_exceptions) {
+            if (exception) {
+                std::rethrow_exception(exception);
+            }
+        }
+    }
+
+    template<typename TypeTag>
+    void
+    BlackoilWellModel<TypeTag>::
+    gasLiftOptimizationStage(Opm::DeferredLogger& deferred_logger)
+    {
+        if (param_.glift_group_allocation_) {
+            allocateLiftGas(deferred_logger);
+            return;
+        }
+
+        // The optimization of a well only computes rates of the well itself
+        // and sets its own ALQ.
+        forEachWellConcurrently([this](const int w, Opm::DeferredLogger& logger)
+                                {
+                                    well_container_[w]->maybeDoGasLiftOptimization(well_state_, ebosSimulator_, logger);
+                                }, deferred_logger);
+    }
+
+    template<typename TypeTag>
+    void
+    BlackoilWellModel<TypeTag>::
+    allocateLiftGas(Opm::DeferredLogger& deferred_logger)
+    {
+        // The optimization of a well is set up on one thread and finished on
+        // another, so each well logs to its own logger.
+        const int nw = well_container_.size();
+        std::vector<Opm::DeferredLogger> well_loggers(nw);
+        std::vector<std::unique_ptr<GasLiftRuntime<TypeTag>>> glift(nw);
+        // The collective calls below must be reached on all processes, so an
+        // exception is only rethrown at the end.
+        std::exception_ptr exception;
+
+        // Distributed wells are optimized on their own, the other wells
+        // compute the gradient of their first increment.
+        try {
+            forEachWellConcurrently([this, &well_loggers, &glift](const int w, Opm::DeferredLogger&)
+                                    {
+                                        const auto& well = well_container_[w];
+                                        if (well->parallelWellInfo().communication().size() > 1) {
+                                            well->maybeDoGasLiftOptimization(well_state_, ebosSimulator_, well_loggers[w]);
+                                            return;
+                                        }
+                                        const auto std_well = std::dynamic_pointer_cast<StandardWell<TypeTag>>(well);
+                                        if (std_well) {
+                                            glift[w] = std_well->initGasLiftOptimization(well_state_, ebosSimulator_,
+                                                                                         well_loggers[w]);
+                                            if (glift[w]) {
+                                                glift[w]->nextIncrementGradient();
+                                            }
+                                        }
+                                    }, deferred_logger);
+        } catch (...) {
+            exception = std::current_exception();
+        }
+
+        // Lift gas used by the groups, including their subgroups, and the
+        // lift gas supply limits of the groups (GLIFTOPT).
+        const int ng = group_tree_.numGroups();
+        const GasLiftOpt& glo = schedule().glo(ebosSimulator_.episodeIndex());
+        std::vector<double> group_alq(ng, 0.0);
+        std::vector<double> group_limit(ng, std::numeric_limits<double>::max());
+        std::vector<int> well_group(nw, -1);
+        for (int w = 0; w < nw; ++w) {
+            const auto& well = well_container_[w];
+            well_group[w] = group_tree_.groupIndex(well->wellEcl().groupName());
+            if (well->isProducer() && well->parallelWellInfo().isOwner() && well_group[w] >= 0) {
+                group_alq[well_group[w]] += well_state_.getALQ(well->name());
+            }
+        }
+        const auto& comm = ebosSimulator_.vanguard().grid().comm();
+        comm.sum(group_alq.data(), group_alq.size());
+        for (int g = ng - 1; g > 0; --g) {
+            group_alq[group_tree_.parent(g)] += group_alq[g];
+        }
+        for (int g = 0; g < ng; ++g) {
+            const auto& name = group_tree_.groupName(g);
+            if (glo.has_group(name)) {
+                const auto& max_lift_gas = glo.group(name).max_lift_gas();
+                if (max_lift_gas) {
+                    group_limit[g] = *max_lift_gas;
+                }
+            }
+        }
+        auto fitsGroupLimits = [this, &group_alq, &group_limit](const int group, const double alq)
+        {
+            for (int g = group; g >= 0; g = group_tree_.parent(g)) {
+                if (group_alq[g] + alq > group_limit[g]) {
+                    return false;
+                }
+            }
+            return true;
+        };
+
+        // Give one increment at a time to the well with the largest gradient
+        // over all processes. A well that cannot take its next increment drops
+        // out, as neither its gradient nor the room left in its groups grow.
+        // Only the well that got the increment computes a new gradient.
+        const double eco_grad = glo.min_eco_gradient();
+        constexpr double no_gradient = std::numeric_limits<double>::lowest();
+        std::vector<char> candidate(nw);
+        for (int w = 0; w < nw; ++w) {
+            candidate[w] = glift[w] && glift[w]->optimizeEnabled();
+        }
+        while (true) {
+            int best = -1;
+            double best_gradient = no_gradient;
+            for (int w = 0; w < nw; ++w) {
+                if (!candidate[w]) {
+                    continue;
+                }
+                std::optional<double> gradient;
+                try {
+                    gradient = glift[w]->nextIncrementGradient();
+                } catch (...) {
+                    exception = std::current_exception();
+                }
+                if (!gradient || *gradient <= eco_grad
+                    || !fitsGroupLimits(well_group[w], glift[w]->nextIncrementSize())) {
+                    candidate[w] = false;
+                    continue;
+                }
+                if (*gradient > best_gradient) {
+                    best = w;
+                    best_gradient = *gradient;
+                }
+            }
+            const double max_gradient = comm.max(best_gradient);
+            if (max_gradient == no_gradient) {
+                break;
+            }
+            // on ties the process with the lowest rank gets the increment
+            const int owner = comm.min(best >= 0 && best_gradient == max_gradient ? comm.rank() : comm.size());
+            // ALQ increment and group of the well
+            std::array<double, 2> step = {0.0, 0.0};
+            if (owner == comm.rank()) {
+                step = {glift[best]->nextIncrementSize(), static_cast<double>(well_group[best])};
+                glift[best]->acceptNextIncrement();
+            }
+            comm.sum(step.data(), step.size());
+            for (int g = static_cast<int>(step[1]); g >= 0; g = group_tree_.parent(g)) {
+                group_alq[g] += step[0];
+            }
+        }
+
+        // Wells without any increment may still decrease their lift gas.
+        try {
+            forEachWellConcurrently([&glift](const int w, Opm::DeferredLogger&)
+                                    {
+                                        if (glift[w]) {
+                                            glift[w]->finishAllocation();
+                                        }
+                                    }, deferred_logger);
+        } catch (...) {
+            exception = std::current_exception();
+        }
+
+        for (const auto& logger : well_loggers) {
+            deferred_logger.append(logger);
+        }
+        if (exception) {
+            std::rethrow_exception(exception);
         }
     }
 
@@ -1014,9 +1298,7 @@ namespace Opm {
             return;
         }
 
-        for (auto& well : well_container_) {
-            well->apply(r);
-        }
+        forEachWellByColor([&r](const auto& well) { well->apply(r); });
     }
 
 
@@ -1031,8 +1313,115 @@ namespace Opm {
             return;
         }
 
-        for (auto& well : well_container_) {
-            well->apply(x, Ax);
+        forEachWellByColor([&x, &Ax](const auto& well) { well->apply(x, Ax); });
+    }
+
+
+
+    template<typename TypeTag>
+    void
+    BlackoilWellModel<TypeTag>::
+    updatePerforatedCells()
+    {
+        std::fill(is_cell_perforated_.begin(), is_cell_perforated_.end(), false);
+        well_container_index_.clear();
+
+        // count the perforations of each cell, and turn the counts into
+        // offsets into cell_perforations_
+        cell_perforations_offset_.assign(local_num_cells_ + 1, 0);
+        const int nw = well_container_.size();
+        for (int w = 0; w < nw; ++w) {
+            const auto& well = well_container_[w];
+            well->updatePerforatedCell(is_cell_perforated_);
+            well_container_index_.emplace(well->name(), w);
+            for (const int cell : well->cells()) {
+                ++cell_perforations_offset_[cell + 1];
+            }
+        }
+        std::partial_sum(cell_perforations_offset_.begin(), cell_perforations_offset_.end(),
+                         cell_perforations_offset_.begin());
+
+        cell_perforations_.resize(cell_perforations_offset_.back());
+        std::vector<int> next(cell_perforations_offset_.begin(), cell_perforations_offset_.end() - 1);
+        for (int w = 0; w < nw; ++w) {
+            const auto& cells = well_container_[w]->cells();
+            for (int perf = 0; perf < static_cast<int>(cells.size()); ++perf) {
+                cell_perforations_[next[cells[perf]]++] = {w, perf};
+            }
+        }
+    }
+
+
+
+    template<typename TypeTag>
+    void
+    BlackoilWellModel<TypeTag>::
+    computeWellColors()
+    {
+        // Greedy coloring: a well gets the first color none of whose wells
+        // perforates one of its cells. Wells seldom share cells, hence
+        // there are usually very few colors.
+        wells_by_color_.clear();
+        distributed_wells_.clear();
+        std::vector<std::vector<bool>> cells_of_color;
+        for (int w = 0; w < static_cast<int>(well_container_.size()); ++w) {
+            const auto& well = well_container_[w];
+            if (well->parallelWellInfo().communication().size() > 1) {
+                distributed_wells_.push_back(w);
+                continue;
+            }
+            const auto& cells = well->cells();
+            std::size_t color = 0;
+            for (; color < cells_of_color.size(); ++color) {
+                const auto& used = cells_of_color[color];
+                if (std::none_of(cells.begin(), cells.end(), [&used](const int c) { return used[c]; })) {
+                    break;
+                }
+            }
+            if (color == cells_of_color.size()) {
+                cells_of_color.emplace_back(local_num_cells_, false);
+                wells_by_color_.emplace_back();
+            }
+            for (const int c : cells) {
+                cells_of_color[color][c] = true;
+            }
+            wells_by_color_[color].push_back(w);
+        }
+    }
+
+
+
+    template<typename TypeTag>
+    template <class Function>
+    void
+    BlackoilWellModel<TypeTag>::
+    forEachWellByColor(Function&& f) const
+    {
+        std::size_t num_colored = distributed_wells_.size();
+        for (const auto& wells : wells_by_color_) {
+            num_colored += wells.size();
+        }
+        // the well container has changed since the coloring was computed
+        if (num_colored != well_container_.size()) {
+            for (const auto& well : well_container_) {
+                f(well);
+            }
+            return;
+        }
+
+        for (const auto& wells : wells_by_color_) {
+            const int num_wells = wells.size();
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic) num_threads(ThreadManager::maxThreads()) if(num_wells > 1)
+#endif
+            for (int k = 0; k < num_wells; ++k) {
+                f(well_container_[wells[k]]);
+            }
+        }
+
+        // distributed wells communicate in apply, keep the same order on all processes
+        for (const int w : distributed_wells_) {
+            f(well_container_[w]);
         }
     }
 
@@ -1220,15 +1609,104 @@ namespace Opm {
 
 
 
+    template<typename TypeTag>
+    double
+    BlackoilWellModel<TypeTag>::
+    relativeWellResidual(const std::vector<Scalar>& B_avg) const
+    {
+        double residual = 0.0;
+        for (const auto& well : well_container_) {
+            if (well->isOperable()) {
+                residual = std::max(residual, well->massBalanceResidual(B_avg));
+            }
+        }
+        residual = ebosSimulator_.vanguard().grid().comm().max(residual);
+        return residual / param_.tolerance_wells_;
+    }
+
+
+
+
+
+    template<typename TypeTag>
+    void
+    BlackoilWellModel<TypeTag>::
+    resetAndSolveWells(const WellState& well_state)
+    {
+        Opm::DeferredLogger local_deferredLogger;
+
+        well_state_ = well_state;
+
+        int exception_thrown = 0;
+        try {
+            if (localWellsActive()) {
+                updatePerforationIntensiveQuantities();
+                updatePrimaryVariables(local_deferredLogger);
+                initPrimaryVariablesEvaluation();
+                forEachWellConcurrently([this](const int w, Opm::DeferredLogger& logger)
+                                        {
+                                            well_container_[w]->solveWellEquation(ebosSimulator_, well_state_, logger);
+                                        }, local_deferredLogger);
+            }
+        } catch (std::exception& e) {
+            exception_thrown = 1;
+        }
+        logAndCheckForExceptionsAndThrow(local_deferredLogger, exception_thrown, "resetAndSolveWells() failed.", terminal_output_);
+    }
+
+
+
+
+
     template<typename TypeTag>
     void
     BlackoilWellModel<TypeTag>::
     calculateExplicitQuantities(Opm::DeferredLogger& deferred_logger) const
     {
+        // The connection pressures of a distributed standard well need the
+        // values of the perforations on other processes twice. Instead of
+        // exchanging them well by well, this is done in two exchanges for
+        // all distributed standard wells on the grid communicator.
+        std::vector<std::shared_ptr<StandardWell<TypeTag>>> distributed_wells;
+
         // TODO: checking isOperable() ?
         for (auto& well : well_container_) {
+            auto std_well = std::dynamic_pointer_cast<StandardWell<TypeTag>>(well);
+            if (any_distributed_wells_ && std_well && well->parallelWellInfo().communication().size() > 1) {
+                distributed_wells.push_back(std_well);
+                continue;
+            }
             well->calculateExplicitQuantities(ebosSimulator_, well_state_, deferred_logger);
         }
+
+        if (!any_distributed_wells_) {
+            return;
+        }
+
+        const auto& comm = ebosSimulator_.vanguard().grid().comm();
+        std::vector<std::size_t> positions(distributed_wells.size());
+
+        GlobalPerfContainerBatch press_rates(comm);
+        for (std::size_t i = 0; i < distributed_wells.size(); ++i) {
+            auto& well = distributed_wells[i];
+            well->updatePrimaryVariables(well_state_, deferred_logger);
+            well->initPrimaryVariablesEvaluation();
+            positions[i] = well->addPerforationPressuresAndRates(press_rates, well_state_);
+        }
+        press_rates.exchange();
+
+        GlobalPerfContainerBatch depth_density(comm);
+        for (std::size_t i = 0; i < distributed_wells.size(); ++i) {
+            positions[i] = distributed_wells[i]->addConnectionDensities(depth_density, ebosSimulator_, well_state_,
+                                                                        press_rates.global(positions[i]));
+        }
+        depth_density.exchange();
+
+        for (std::size_t i = 0; i < distributed_wells.size(); ++i) {
+            auto& well = distributed_wells[i];
+            well->computeConnectionPressureDelta(depth_density.global(positions[i]));
+            well->computeAccumWell();
+        }
     }
 
 
@@ -1247,7 +1725,7 @@ namespace Opm {
 
         updateAndCommunicateGroupData();
 
-        updateNetworkPressures();
+        updateNetworkPressures(deferred_logger);
 
         std::set<std::string> switched_wells;
         std::set<std::string> switched_groups;
@@ -1290,7 +1768,7 @@ namespace Opm {
     template<typename TypeTag>
     void
     BlackoilWellModel<TypeTag>::
-    updateNetworkPressures()
+    updateNetworkPressures(Opm::DeferredLogger& deferred_logger)
     {
         // Get the network and return if inactive.
         const int reportStepIdx = ebosSimulator_.episodeIndex();
@@ -1298,8 +1776,60 @@ namespace Opm {
         if (!network.active()) {
             return;
         }
+
+        // Change of the inflow of the leaf nodes with the node pressure,
+        // from the wells producing at their thp limit. Only available once
+        // the node pressures have been computed.
+        std::map<std::string, std::vector<double>> inflow_derivatives;
+        if (!node_pressures_.empty()) {
+            const int np = numPhases();
+            for (const auto& well : well_container_) {
+                if (!well->isProducer()) {
+                    continue;
+                }
+                const auto it = node_pressures_.find(well->wellEcl().groupName());
+                if (it == node_pressures_.end()) {
+                    continue;
+                }
+                // Called on all processes of a distributed well, as the ipr
+                // is communicated, but only counted once.
+                const auto derivatives = well->productionRateDerivativesThp(ebosSimulator_, well_state_, deferred_logger);
+                if (!well->parallelWellInfo().isOwner()) {
+                    continue;
+                }
+                auto& group_derivatives = inflow_derivatives[it->first];
+                group_derivatives.resize(np, 0.0);
+                const double efficiency = well->wellEcl().getEfficiencyFactor();
+                for (int p = 0; p < np; ++p) {
+                    group_derivatives[p] += efficiency * derivatives[p];
+                }
+            }
+
+            // Sum over the processes, in the order of the nodes.
+            std::vector<double> flat(node_pressures_.size() * np, 0.0);
+            int node_index = 0;
+            for (const auto& [node, pressure] : node_pressures_) {
+                const auto it = inflow_derivatives.find(node);
+                if (it != inflow_derivatives.end()) {
+                    std::copy(it->second.begin(), it->second.end(), flat.begin() + node_index * np);
+                }
+                ++node_index;
+            }
+            ebosSimulator_.vanguard().grid().comm().sum(flat.data(), flat.size());
+            inflow_derivatives.clear();
+            node_index = 0;
+            for (const auto& [node, pressure] : node_pressures_) {
+                const auto begin = flat.begin() + node_index * np;
+                if (std::any_of(begin, begin + np, [](const double d) { return d != 0.0; })) {
+                    inflow_derivatives[node].assign(begin, begin + np);
+                }
+                ++node_index;
+            }
+        }
+
         node_pressures_ = WellGroupHelpers::computeNetworkPressures(
-            network, well_state_, *(vfp_properties_->getProd()), schedule(), reportStepIdx);
+            network, well_state_, *(vfp_properties_->getProd()), schedule(), reportStepIdx,
+            node_pressures_, inflow_derivatives);
 
         // Set the thp limits of wells
         for (auto& well : well_container_) {
@@ -1336,31 +1866,30 @@ namespace Opm {
         well_state_.updateGlobalIsGrup(schedule(), reportStepIdx, comm);
 
         if (iterationIdx < nupcol) {
+            // The snapshot reuses the storage of the previous one, and the
+            // name lookup tables are shared, so this amounts to copying the
+            // flat arrays of the state.
             well_state_nupcol_ = well_state_;
         }
 
         // the group target reduction rates needs to be update since wells may have swicthed to/from GRUP control
         // Currently the group target reduction does not honor NUPCOL. TODO: is that true?
-        std::vector<double> groupTargetReduction(numPhases(), 0.0);
-        WellGroupHelpers::updateGroupTargetReduction(fieldGroup, schedule(), reportStepIdx, /*isInjector*/ false, phase_usage_, *guideRate_, well_state_nupcol_, well_state_, groupTargetReduction);
-        std::vector<double> groupTargetReductionInj(numPhases(), 0.0);
-        WellGroupHelpers::updateGroupTargetReduction(fieldGroup, schedule(), reportStepIdx, /*isInjector*/ true, phase_usage_, *guideRate_, well_state_nupcol_, well_state_, groupTargetReductionInj);
+        WellGroupHelpers::updateGroupTargetReduction(group_tree_, /*isInjector*/ false, phase_usage_, *guideRate_, well_state_nupcol_, well_state_);
+        WellGroupHelpers::updateGroupTargetReduction(group_tree_, /*isInjector*/ true, phase_usage_, *guideRate_, well_state_nupcol_, well_state_);
 
         const double simulationTime = ebosSimulator_.time();
-        std::vector<double> pot(numPhases(), 0.0);
-        WellGroupHelpers::updateGuideRateForGroups(fieldGroup, schedule(), phase_usage_, reportStepIdx, simulationTime, /*isInjector*/ false, well_state_, comm, guideRate_.get(), pot);
-        std::vector<double> potInj(numPhases(), 0.0);
-        WellGroupHelpers::updateGuideRateForGroups(fieldGroup, schedule(), phase_usage_, reportStepIdx, simulationTime, /*isInjector*/ true, well_state_, comm, guideRate_.get(), potInj);
+        WellGroupHelpers::updateGuideRateForGroups(group_tree_, phase_usage_, reportStepIdx, simulationTime, /*isInjector*/ false, well_state_, comm, guideRate_.get());
+        WellGroupHelpers::updateGuideRateForGroups(group_tree_, phase_usage_, reportStepIdx, simulationTime, /*isInjector*/ true, well_state_, comm, guideRate_.get());
 
         const auto& summaryState = ebosSimulator_.vanguard().summaryState();
-        WellGroupHelpers::updateREINForGroups(fieldGroup, schedule(), reportStepIdx, phase_usage_, summaryState, well_state_nupcol_, well_state_);
-        WellGroupHelpers::updateVREPForGroups(fieldGroup, schedule(), reportStepIdx, well_state_nupcol_, well_state_);
+        WellGroupHelpers::updateREINForGroups(group_tree_, schedule(), reportStepIdx, phase_usage_, summaryState, well_state_nupcol_, well_state_);
+        WellGroupHelpers::updateVREPForGroups(group_tree_, well_state_nupcol_, well_state_);
 
-        WellGroupHelpers::updateReservoirRatesInjectionGroups(fieldGroup, schedule(), reportStepIdx, well_state_nupcol_, well_state_);
-        WellGroupHelpers::updateGroupProductionRates(fieldGroup, schedule(), reportStepIdx, well_state_nupcol_, well_state_);
+        WellGroupHelpers::updateReservoirRatesInjectionGroups(group_tree_, well_state_nupcol_, well_state_);
+        WellGroupHelpers::updateGroupProductionRates(group_tree_, well_state_nupcol_, well_state_);
 
         // We use the rates from the privious time-step to reduce oscilations
-        WellGroupHelpers::updateWellRates(fieldGroup, schedule(), reportStepIdx, previous_well_state_, well_state_);
+        WellGroupHelpers::updateWellRates(group_tree_, previous_well_state_, well_state_);
 
         // Set ALQ for off-process wells to zero
         for (const auto& wname : schedule().wellNames(reportStepIdx)) {
@@ -1409,8 +1938,6 @@ namespace Opm {
         const int np = numPhases();
         well_potentials.resize(nw * np, 0.0);
 
-        auto well_state_copy = well_state_;
-
         // average B factors are required for the convergence checking of well equations
         // Note: this must be done on all processes, even those with
         // no wells needing testing, otherwise we will have locking.
@@ -1419,8 +1946,18 @@ namespace Opm {
 
         const Opm::SummaryConfig& summaryConfig = ebosSimulator_.vanguard().summaryConfig();
         const bool write_restart_file = ebosSimulator_.vanguard().schedule().restart().getWriteRestartFile(reportStepIdx);
-        int exception_thrown = 0;
-        for (const auto& well : well_container_) {
+
+        // The potential of a well only depends on the well state through its
+        // own entries, so the potentials of the wells that are not shared with
+        // other processes are computed concurrently. The trial solutions of a
+        // well are done on its own entries of the shared scratch well state,
+        // see scratchWellState(). Distributed wells communicate and are
+        // handled afterwards in the same order on all processes.
+        std::vector<int> local_wells;
+        std::vector<int> distributed_wells;
+        local_wells.reserve(well_container_.size());
+        for (int w = 0; w < static_cast<int>(well_container_.size()); ++w) {
+            const auto& well = well_container_[w];
             const bool needed_for_summary = ((summaryConfig.hasSummaryKey( "WWPI:" + well->name()) ||
                                               summaryConfig.hasSummaryKey( "WOPI:" + well->name()) ||
                                               summaryConfig.hasSummaryKey( "WGPI:" + well->name())) && well->isInjector()) ||
@@ -1431,18 +1968,49 @@ namespace Opm {
             bool needPotentialsForGuideRate = true;//eclWell.getGuideRatePhase() == Well::GuideRateTarget::UNDEFINED;
             if (write_restart_file || needed_for_summary || needPotentialsForGuideRate)
             {
-                try {
-                    std::vector<double> potentials;
-                    well->computeWellPotentials(ebosSimulator_, B_avg, well_state_copy, potentials, deferred_logger);
-                    // putting the sucessfully calculated potentials to the well_potentials
-                    for (int p = 0; p < np; ++p) {
-                        well_potentials[well->indexOfWell() * np + p] = std::abs(potentials[p]);
-                    }
-                } catch (std::exception& e) {
-                    exception_thrown = 1;
+                if (well->parallelWellInfo().communication().size() > 1) {
+                    distributed_wells.push_back(w);
+                } else {
+                    local_wells.push_back(w);
+                }
+            }
+        }
+
+        const int num_threads = ThreadManager::maxThreads();
+        std::vector<Opm::DeferredLogger> thread_loggers(num_threads);
+        std::vector<int> thread_exception_thrown(num_threads, 0);
+        WellState& scratch_state = scratchWellState();
+
+        auto computePotentials = [&](const int w, const int thread_id) {
+            auto& well = well_container_[w];
+            well->setScratchWellState(&scratch_state);
+            try {
+                std::vector<double> potentials;
+                well->computeWellPotentials(ebosSimulator_, B_avg, well_state_, potentials, thread_loggers[thread_id]);
+                // putting the sucessfully calculated potentials to the well_potentials
+                for (int p = 0; p < np; ++p) {
+                    well_potentials[well->indexOfWell() * np + p] = std::abs(potentials[p]);
                 }
+            } catch (std::exception& e) {
+                thread_exception_thrown[thread_id] = 1;
             }
+            well->setScratchWellState(nullptr);
+        };
+
+        const int num_local_wells = local_wells.size();
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic) num_threads(num_threads)
+#endif
+        for (int k = 0; k < num_local_wells; ++k) {
+            computePotentials(local_wells[k], ThreadManager::threadId());
+        }
+        for (const int w : distributed_wells) {
+            computePotentials(w, 0);
         }
+        for (const auto& logger : thread_loggers) {
+            deferred_logger.append(logger);
+        }
+        const int exception_thrown = *std::max_element(thread_exception_thrown.begin(), thread_exception_thrown.end());
         logAndCheckForExceptionsAndThrow(deferred_logger, exception_thrown, "computeWellPotentials() failed.", terminal_output_);
 
         // Store it in the well state
@@ -1456,6 +2024,21 @@ namespace Opm {
 
 
 
+    template<typename TypeTag>
+    typename BlackoilWellModel<TypeTag>::WellState&
+    BlackoilWellModel<TypeTag>::
+    scratchWellState()
+    {
+        if (!scratch_well_state_) {
+            scratch_well_state_ = well_state_;
+        }
+        return *scratch_well_state_;
+    }
+
+
+
+
+
     template<typename TypeTag>
     void
     BlackoilWellModel<TypeTag>::
@@ -1528,6 +2111,61 @@ namespace Opm {
     wellState(const WellState& well_state OPM_UNUSED) const { return wellState(); }
 
 
+
+
+
+    template<typename TypeTag>
+    void
+    BlackoilWellModel<TypeTag>::
+    predictWellState(const std::vector<const WellState*>& wellStates,
+                     const std::vector<double>& coefficients)
+    {
+        assert(wellStates.size() == coefficients.size());
+        const int np = numPhases();
+        for (const auto& [name, wellIndices] : well_state_.wellMap()) {
+            const int w = wellIndices[0];
+            bool samePhysics = true;
+            std::vector<int> stateWellIdx;
+            for (const auto* state : wellStates) {
+                const auto it = state->wellMap().find(name);
+                if (it == state->wellMap().end()) {
+                    samePhysics = false;
+                    break;
+                }
+                const int sw = it->second[0];
+                samePhysics = samePhysics
+                    && state->currentProductionControls()[sw] == well_state_.currentProductionControls()[w]
+                    && state->currentInjectionControls()[sw] == well_state_.currentInjectionControls()[w];
+                stateWellIdx.push_back(sw);
+            }
+            if (!samePhysics) {
+                continue;
+            }
+
+            double bhp = 0.0;
+            std::vector<double> rates(np, 0.0);
+            for (std::size_t i = 0; i < wellStates.size(); ++i) {
+                bhp += coefficients[i] * wellStates[i]->bhp()[stateWellIdx[i]];
+                for (int p = 0; p < np; ++p) {
+                    rates[p] += coefficients[i] * wellStates[i]->wellRates()[np*stateWellIdx[i] + p];
+                }
+            }
+            bool sameSigns = bhp > 0.0;
+            for (int p = 0; p < np; ++p) {
+                sameSigns = sameSigns && rates[p] * well_state_.wellRates()[np*w + p] >= 0.0;
+            }
+            if (!sameSigns) {
+                continue;
+            }
+
+            well_state_.bhp()[w] = bhp;
+            for (int p = 0; p < np; ++p) {
+                well_state_.wellRates()[np*w + p] = rates[p];
+            }
+        }
+    }
+
+
     template<typename TypeTag>
     void
     BlackoilWellModel<TypeTag>::
@@ -1539,8 +2177,8 @@ namespace Opm {
 
         for (auto& well : well_container_) {
             const Well& wellEcl = well->wellEcl();
-            double well_efficiency_factor = wellEcl.getEfficiencyFactor();
-            WellGroupHelpers::accumulateGroupEfficiencyFactor(schedule().getGroup(wellEcl.groupName(), reportStepIdx), schedule(), reportStepIdx, well_efficiency_factor);
+            const double well_efficiency_factor = wellEcl.getEfficiencyFactor()
+                * group_tree_.accumulatedEfficiencyFactor(wellEcl.groupName());
             well->setWellEfficiencyFactor(well_efficiency_factor);
         }
     }
@@ -1891,16 +2529,11 @@ namespace Opm {
     BlackoilWellModel<TypeTag>::
     getWell(const std::string& well_name) const
     {
-        // finding the iterator of the well in wells_ecl
-        auto well = std::find_if(well_container_.begin(),
-                                     well_container_.end(),
-                                     [&well_name](const WellInterfacePtr& elem)->bool {
-                                         return elem->name() == well_name;
-                                     });
+        const auto it = well_container_index_.find(well_name);
 
-        assert(well != well_container_.end());
+        assert(it != well_container_index_.end());
 
-        return *well;
+        return well_container_[it->second];
     }
 
 
@@ -2645,10 +3278,8 @@ namespace Opm {
                 well->init(&phase_usage_, depth_, gravity_, local_num_cells_, B_avg);
             }
 
-            std::fill(is_cell_perforated_.begin(), is_cell_perforated_.end(), false);
-            for (auto& well : well_container_) {
-                well->updatePerforatedCell(is_cell_perforated_);
-            }
+            updatePerforatedCells();
+            computeWellColors();
 
             this->calculateProductivityIndexValues(local_deferredLogger);
 
@@ -71,7 +71,39 @@ namespace Opm
             const Well::ProductionControls &controls
         );
         void runOptimize();
+
+        // Allocation of the lift gas in increments to several wells at
+        // once. The caller repeatedly gives the next increment to the well
+        // with the largest incremental gradient, and calls
+        // finishAllocation() when it is done.
+
+        // Is the lift gas of the well optimized, i.e. not fixed?
+        bool optimizeEnabled() const { return this->optimize_; }
+        // Weighted incremental gradient of adding the next lift gas
+        // increment to the well, or nothing if the well cannot take
+        // another increment.
+        std::optional<double> nextIncrementGradient();
+        // Change of ALQ by the next increment.
+        double nextIncrementSize() const;
+        // Add the next increment to the ALQ of the well.
+        void acceptNextIncrement();
+        // If the well did not get any increment, try to decrease its lift
+        // gas as runOptimize() does. Stores the new ALQ in the well state.
+        void finishAllocation();
     private:
+        // Lift gas increment evaluated for the allocation over wells.
+        struct Increment {
+            double alq;
+            double gradient;
+            double oil_rate;
+            double gas_rate;
+            std::vector<double> potentials;
+            // the bhp limit was reached, no further increments
+            bool last;
+        };
+
+        std::optional<double> bhpAtThpLimit_(double alq);
+        std::optional<Increment> computeNextIncrement_();
         void computeInitialWellRates_();
         void computeWellRates_(double bhp, std::vector<double> &potentials);
         void debugShowIterationInfo_(OptimizeState &state, double alq);
@@ -91,7 +123,7 @@ namespace Opm
         bool useFixedAlq_(const GasLiftOpt::Well &well);
         void warnMaxIterationsExceeded_();
 
-        const Well::ProductionControls &controls_;
+        const Well::ProductionControls controls_;
         DeferredLogger &deferred_logger_;
         const Simulator &ebos_simulator_;
         std::vector<double> potentials_;
@@ -116,6 +148,20 @@ namespace Opm
         double orig_alq_;
         int water_pos_;
 
+        // The well rates and the bhp at the THP limit only depend on the
+        // ALQ and the bhp as long as the reservoir state does not change,
+        // i.e. during the optimization in one Newton iteration. They are
+        // therefore computed once for each value.
+        std::map<double, std::optional<double>> bhp_at_thp_limit_memo_;
+        std::map<double, std::vector<double>> well_rates_memo_;
+
+        // state of the allocation over wells
+        std::optional<Increment> next_increment_;
+        bool next_increment_computed_ = false;
+        bool stop_increments_ = false;
+        double alloc_oil_rate_;
+        double alloc_gas_rate_;
+
         struct OptimizeState {
             OptimizeState( GasLiftRuntime &parent_, bool increase_ ) :
                 parent(parent_),
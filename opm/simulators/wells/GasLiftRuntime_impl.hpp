@@ -25,8 +25,11 @@
 #include <opm/simulators/wells/WellStateFullyImplicitBlackoil.hpp>
 #include <opm/parser/eclipse/EclipseState/Schedule/GasLiftOpt.hpp>
 
+#include <algorithm>
+#include <cassert>
 #include <optional>
 #include <string>
+#include <utility>
 
 template<typename TypeTag>
 Opm::GasLiftRuntime<TypeTag>::
@@ -110,6 +113,8 @@ GasLiftRuntime(
         this->gas_pos_ = pu.phase_pos[Gas];
         this->water_pos_ = pu.phase_pos[Water];
         this->new_alq_ = this->orig_alq_;
+        this->alloc_oil_rate_ = -this->potentials_[this->oil_pos_];
+        this->alloc_gas_rate_ = -this->potentials_[this->gas_pos_];
         // TODO: adhoc value.. Should we keep max_iterations_ as a safety measure
         //   or does it not make sense to have it?
         this->max_iterations_ = 1000;
@@ -120,6 +125,36 @@ GasLiftRuntime(
  * Methods in alphabetical order
  ****************************************/
 
+template<typename TypeTag>
+void
+Opm::GasLiftRuntime<TypeTag>::
+acceptNextIncrement()
+{
+    assert(this->next_increment_computed_ && this->next_increment_);
+    auto& increment = *this->next_increment_;
+    this->new_alq_ = increment.alq;
+    this->potentials_ = std::move(increment.potentials);
+    this->alloc_oil_rate_ = increment.oil_rate;
+    this->alloc_gas_rate_ = increment.gas_rate;
+    this->stop_increments_ = increment.last;
+    this->next_increment_.reset();
+    this->next_increment_computed_ = false;
+}
+
+template<typename TypeTag>
+std::optional<double>
+Opm::GasLiftRuntime<TypeTag>::
+bhpAtThpLimit_(double alq)
+{
+    auto it = this->bhp_at_thp_limit_memo_.find(alq);
+    if (it == this->bhp_at_thp_limit_memo_.end()) {
+        const auto bhp = this->std_well_.computeBhpAtThpLimitProdWithAlq(
+            this->ebos_simulator_, this->summary_state_, this->deferred_logger_, alq);
+        it = this->bhp_at_thp_limit_memo_.emplace(alq, bhp).first;
+    }
+    return it->second;
+}
+
 template<typename TypeTag>
 void
 Opm::GasLiftRuntime<TypeTag>::
@@ -129,11 +164,53 @@ computeInitialWellRates_()
     //   if gas lift optimization has not been applied to this well yet, the
     //   default value is used.
     this->orig_alq_ = this->well_state_.getALQ(this->well_name_);
-    // NOTE: compute initial rates with current ALQ
-    this->std_well_.computeWellRatesWithThpAlqProd(
-        this->ebos_simulator_, this->summary_state_, this->deferred_logger_,
-        this->potentials_, this->orig_alq_);
+    // NOTE: compute initial rates with current ALQ, in the same way as
+    //   StandardWell::computeWellRatesWithThpAlqProd(), but through the memos
+    double bhp = this->controls_.bhp_limit;
+    const auto bhp_at_thp_limit = bhpAtThpLimit_(this->orig_alq_);
+    if (bhp_at_thp_limit) {
+        bhp = std::max(*bhp_at_thp_limit, this->controls_.bhp_limit);
+    }
+    else {
+        this->deferred_logger_.warning("FAILURE_GETTING_CONVERGED_POTENTIAL",
+            "Failed in getting converged thp based potential calculation for well "
+            + this->well_name_ + ". Instead the bhp based value is used");
+    }
+    computeWellRates_(bhp, this->potentials_);
+}
 
+// Evaluate adding one lift gas increment to the current allocation, with
+// the same checks as an iteration of runOptimizeLoop_() when increasing.
+template<typename TypeTag>
+std::optional<typename Opm::GasLiftRuntime<TypeTag>::Increment>
+Opm::GasLiftRuntime<TypeTag>::
+computeNextIncrement_()
+{
+    if (this->stop_increments_)
+        return std::nullopt;
+    OptimizeState state {*this, /*increase=*/true};
+    ++state.it;
+    if (state.checkWellRatesViolated(this->potentials_))
+        return std::nullopt;
+    if (state.checkAlqOutsideLimits(this->new_alq_, this->alloc_oil_rate_))
+        return std::nullopt;
+    const double alq = state.addOrSubtractAlqIncrement(this->new_alq_);
+    if (this->debug) debugShowIterationInfo_(state, alq);
+    if (!state.computeBhpAtThpLimit(alq))
+        return std::nullopt;
+    // NOTE: if BHP is below limit, we set state.stop_iteration = true
+    const double bhp = state.getBhpWithLimit();
+    std::vector<double> potentials;
+    computeWellRates_(bhp, potentials);
+    double new_oil_rate = 0.0;
+    getOilRateWithLimit_(new_oil_rate, potentials);
+    double new_gas_rate = 0.0;
+    if (getGasRateWithLimit_(new_gas_rate, potentials)) // gas is limited, do not increase
+        return std::nullopt;
+    const double gradient = state.calcGradient(
+        this->alloc_oil_rate_, new_oil_rate, this->alloc_gas_rate_, new_gas_rate);
+    return Increment{alq, gradient, new_oil_rate, new_gas_rate,
+                     std::move(potentials), state.stop_iteration};
 }
 
 template<typename TypeTag>
@@ -141,9 +218,14 @@ void
 Opm::GasLiftRuntime<TypeTag>::
 computeWellRates_(double bhp, std::vector<double> &potentials)
 {
-    this->std_well_.computeWellRatesWithBhp(
-        this->ebos_simulator_, bhp, potentials, this->deferred_logger_);
-
+    auto it = this->well_rates_memo_.find(bhp);
+    if (it == this->well_rates_memo_.end()) {
+        std::vector<double> rates(this->well_state_.numPhases(), 0.0);
+        this->std_well_.computeWellRatesWithBhp(
+            this->ebos_simulator_, bhp, rates, this->deferred_logger_);
+        it = this->well_rates_memo_.emplace(bhp, std::move(rates)).first;
+    }
+    potentials = it->second;
 }
 
 template<typename TypeTag>
@@ -189,6 +271,22 @@ displayWarning_(std::string msg)
     this->deferred_logger_.warning("WARNING", message);
 }
 
+template<typename TypeTag>
+void
+Opm::GasLiftRuntime<TypeTag>::
+finishAllocation()
+{
+    if (this->optimize_) {
+        if (this->new_alq_ == this->orig_alq_) {
+            if (!tryDecreaseLiftGas_()) {
+                return;
+            }
+        }
+        logSuccess_();
+        this->well_state_.setALQ(this->well_name_, this->new_alq_);
+    }
+}
+
 // TODO: what if the gas_rate_target_ has been defaulted
 //   (i.e. value == 0, meaning: "No limit") but the
 //   oil_rate_target_ has not been defaulted ?
@@ -270,6 +368,31 @@ logSuccess_()
     this->deferred_logger_.info(message);
 }
 
+template<typename TypeTag>
+std::optional<double>
+Opm::GasLiftRuntime<TypeTag>::
+nextIncrementGradient()
+{
+    if (!this->optimize_)
+        return std::nullopt;
+    if (!this->next_increment_computed_) {
+        this->next_increment_ = computeNextIncrement_();
+        this->next_increment_computed_ = true;
+    }
+    if (!this->next_increment_)
+        return std::nullopt;
+    return this->next_increment_->gradient;
+}
+
+template<typename TypeTag>
+double
+Opm::GasLiftRuntime<TypeTag>::
+nextIncrementSize() const
+{
+    assert(this->next_increment_computed_ && this->next_increment_);
+    return this->next_increment_->alq - this->new_alq_;
+}
+
 /* - At this point we know that this is a production well, and that its current
  * control mode is THP.
  *
@@ -765,11 +888,7 @@ bool
 Opm::GasLiftRuntime<TypeTag>::OptimizeState::
 computeBhpAtThpLimit(double alq)
 {
-    auto bhp_at_thp_limit = this->parent.std_well_.computeBhpAtThpLimitProdWithAlq(
-        this->parent.ebos_simulator_,
-        this->parent.summary_state_,
-        this->parent.deferred_logger_,
-        alq);
+    auto bhp_at_thp_limit = this->parent.bhpAtThpLimit_(alq);
     if (!bhp_at_thp_limit) {
         const std::string msg = fmt::format(
           "Failed in getting converged bhp potential for well {}",
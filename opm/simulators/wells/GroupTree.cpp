@@ -0,0 +1,107 @@
+/*
+  Copyright 2021 Equinor ASA.
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <config.h>
+#include <opm/simulators/wells/GroupTree.hpp>
+#include <opm/simulators/wells/WellStateFullyImplicitBlackoil.hpp>
+
+#include <opm/common/ErrorMacros.hpp>
+#include <opm/parser/eclipse/EclipseState/Schedule/Group/Group.hpp>
+#include <opm/parser/eclipse/EclipseState/Schedule/Schedule.hpp>
+#include <opm/parser/eclipse/EclipseState/Schedule/Well/Well.hpp>
+
+#include <stack>
+#include <stdexcept>
+#include <utility>
+
+namespace Opm {
+
+GroupTree::GroupTree(const Schedule& schedule, const int reportStepIdx)
+{
+    // Depth first from FIELD.  A group is numbered when it is popped, and
+    // its subgroups are pushed only then, so they get larger indices.
+    std::stack<std::pair<std::string, int>> pending;
+    pending.emplace("FIELD", -1);
+    while (!pending.empty()) {
+        const auto [name, parent] = pending.top();
+        pending.pop();
+
+        const Group& group = schedule.getGroup(name, reportStepIdx);
+        const int index = this->names_.insert(name);
+        this->parent_.push_back(parent);
+        this->efficiency_factor_.push_back(group.getGroupEfficiencyFactor());
+
+        // The factor of a group directly below FIELD is its own factor,
+        // FIELD itself does not contribute.
+        double accumulated = group.getGroupEfficiencyFactor();
+        if (parent > 0) {
+            accumulated *= this->accumulated_efficiency_factor_[parent];
+        }
+        this->accumulated_efficiency_factor_.push_back(accumulated);
+
+        for (const std::string& wellName : group.wells()) {
+            const auto& well = schedule.getWell(wellName, reportStepIdx);
+            this->wells_.push_back({wellName,
+                                    index,
+                                    well.getEfficiencyFactor(),
+                                    well.isInjector(),
+                                    well.getStatus() == Well::Status::SHUT});
+        }
+
+        for (const std::string& child : group.groups()) {
+            pending.emplace(child, index);
+        }
+    }
+}
+
+void GroupTree::resolveStateIndices(const WellStateFullyImplicitBlackoil& wellState)
+{
+    this->group_state_index_.resize(this->numGroups());
+    for (int group = 0; group < this->numGroups(); ++group) {
+        const int index = wellState.groupIndex(this->groupName(group));
+        if (index < 0) {
+            OPM_THROW(std::logic_error, "Group " << this->groupName(group) << " is not in the well state");
+        }
+        this->group_state_index_[group] = index;
+    }
+
+    const auto& end = wellState.wellMap().end();
+    for (auto& well : this->wells_) {
+        well.state_index = wellState.wellNameIndex(well.name);
+        if (well.state_index < 0) {
+            OPM_THROW(std::logic_error, "Well " << well.name << " is not in the well state");
+        }
+
+        const auto& it = wellState.wellMap().find(well.name);
+        well.local_index = (it != end) ? it->second[0] : -1;
+        well.owned = (it != end) && wellState.wellIsOwned(well.local_index, well.name);
+    }
+}
+
+double GroupTree::accumulatedEfficiencyFactor(const std::string& name) const
+{
+    const int group = this->groupIndex(name);
+    if (group < 0) {
+        OPM_THROW(std::logic_error, "Group " << name << " is not in the group tree");
+    }
+
+    return this->accumulated_efficiency_factor_[group];
+}
+
+} // namespace Opm
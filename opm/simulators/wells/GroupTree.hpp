@@ -0,0 +1,150 @@
+/*
+  Copyright 2021 Equinor ASA.
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef OPM_GROUPTREE_HEADER_INCLUDED
+#define OPM_GROUPTREE_HEADER_INCLUDED
+
+#include <opm/simulators/wells/NameIndex.hpp>
+
+#include <string>
+#include <vector>
+
+namespace Opm {
+    class Schedule;
+    class WellStateFullyImplicitBlackoil;
+} // namespace Opm
+
+namespace Opm {
+
+    /// Flat representation of the group hierarchy of one report step.
+    ///
+    /// The groups are numbered so that a group always comes after its
+    /// parent, with FIELD as group 0.  A bottom-up accumulation over the
+    /// hierarchy is therefore a single reverse loop over the groups, in
+    /// which each group is complete when it is reached and can be added
+    /// to its parent.  The efficiency factors and the data of the wells
+    /// are looked up in the schedule once, when the tree is built, and
+    /// the indices of the groups and wells in the well state are resolved
+    /// once per report step by resolveStateIndices().
+    class GroupTree
+    {
+    public:
+        /// Static data of a well in the tree.
+        struct WellNode
+        {
+            std::string name;
+            /// Index of the group the well belongs to.
+            int group;
+            double efficiency_factor;
+            bool injector;
+            bool shut;
+            /// Index of the well name in the well state, see
+            /// WellStateFullyImplicitBlackoil::wellNameIndex().
+            int state_index = -1;
+            /// Index of the well in the local wells of the well state, or
+            /// -1 if the well is not on this process.
+            int local_index = -1;
+            /// Whether this process owns the well.
+            bool owned = false;
+        };
+
+        /// Empty tree.
+        GroupTree() = default;
+
+        /// Build the tree of the groups below FIELD at a report step.
+        ///
+        /// \param[in] schedule Schedule holding the group hierarchy.
+        ///
+        /// \param[in] reportStepIdx Report step of the hierarchy.
+        GroupTree(const Schedule& schedule, const int reportStepIdx);
+
+        /// Number of groups, including FIELD.
+        int numGroups() const
+        {
+            return this->names_.size();
+        }
+
+        /// Index of the group \p name, or -1 if the group is not in the
+        /// tree.
+        int groupIndex(const std::string& name) const
+        {
+            return this->names_.index(name);
+        }
+
+        /// Name of the group with index \p group.
+        const std::string& groupName(const int group) const
+        {
+            return this->names_.name(group);
+        }
+
+        /// Index of the parent of the group with index \p group, or -1
+        /// for FIELD.
+        int parent(const int group) const
+        {
+            return this->parent_[group];
+        }
+
+        /// Efficiency factor of the group with index \p group.
+        double groupEfficiencyFactor(const int group) const
+        {
+            return this->efficiency_factor_[group];
+        }
+
+        /// Product of the efficiency factors of the group \p name and of
+        /// its ancestors below FIELD.  This is the factor to apply to the
+        /// rates of a well in the group to get its contribution to the
+        /// field rates.
+        double accumulatedEfficiencyFactor(const std::string& name) const;
+
+        /// All wells of the groups in the tree, ordered by group.
+        const std::vector<WellNode>& wells() const
+        {
+            return this->wells_;
+        }
+
+        /// Look up the indices of the groups and wells in \p wellState.
+        ///
+        /// The well state only ever appends names to its indices, so the
+        /// resolved indices are also valid for copies of \p wellState,
+        /// such as the state at the last NUPCOL iteration, until the
+        /// local wells change at the next report step.
+        ///
+        /// \param[in] wellState Well state initialised for the report
+        ///    step of the tree.
+        void resolveStateIndices(const WellStateFullyImplicitBlackoil& wellState);
+
+        /// Index of the group with index \p group in the well state, see
+        /// WellStateFullyImplicitBlackoil::groupIndex().
+        int groupStateIndex(const int group) const
+        {
+            return this->group_state_index_[group];
+        }
+
+    private:
+        NameIndex names_{};
+        std::vector<int> group_state_index_{};
+        std::vector<int> parent_{};
+        std::vector<double> efficiency_factor_{};
+        std::vector<double> accumulated_efficiency_factor_{};
+        std::vector<WellNode> wells_{};
+    };
+
+} // namespace Opm
+
+#endif // OPM_GROUPTREE_HEADER_INCLUDED
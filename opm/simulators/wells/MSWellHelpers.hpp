@@ -31,7 +31,10 @@
 #if HAVE_UMFPACK
 #include <dune/istl/umfpack.hh>
 #endif // HAVE_UMFPACK
+#include <algorithm>
+#include <cassert>
 #include <cmath>
+#include <vector>
 
 namespace Opm {
 
@@ -164,6 +167,166 @@ namespace mswellhelpers
 
 
 
+    /// Block LU factorization of the matrix D of a multisegment well.
+    ///
+    /// The rows of D only couple a segment to its outlet and its inlets,
+    /// i.e. the sparsity pattern of D is the segment tree. Eliminating the
+    /// segments from the branch ends towards the top segment creates no
+    /// fill-in, so the factors are stored as one block per segment and the
+    /// solves run in linear time without any allocation.
+    template <typename MatrixType, typename VectorType>
+    class SegmentTreeLU
+    {
+    public:
+        using Block = typename MatrixType::block_type;
+
+        /// Factorize D with the inlets given for each segment. Returns
+        /// false if the pattern of D is not the segment tree or a pivot
+        /// block is singular, in which case the factorization is unusable.
+        bool factorize(const MatrixType& D, const std::vector<std::vector<int>>& segment_inlets)
+        {
+            valid_ = false;
+            const int num_seg = D.N();
+            if (static_cast<int>(segment_inlets.size()) != num_seg) {
+                return false;
+            }
+
+            outlet_.assign(num_seg, -1);
+            for (int seg = 0; seg < num_seg; ++seg) {
+                for (const int inlet : segment_inlets[seg]) {
+                    if (inlet < 0 || inlet >= num_seg || outlet_[inlet] != -1) {
+                        return false;
+                    }
+                    outlet_[inlet] = seg;
+                }
+            }
+
+            // elimination order: the inlets of a segment come before the segment
+            order_.clear();
+            order_.reserve(num_seg);
+            std::vector<int> stack;
+            for (int root = 0; root < num_seg; ++root) {
+                if (outlet_[root] != -1) {
+                    continue;
+                }
+                const auto first = order_.size();
+                stack.push_back(root);
+                while (!stack.empty()) {
+                    const int seg = stack.back();
+                    stack.pop_back();
+                    order_.push_back(seg);
+                    stack.insert(stack.end(), segment_inlets[seg].begin(), segment_inlets[seg].end());
+                }
+                std::reverse(order_.begin() + first, order_.end());
+            }
+            // segments on a cycle are not reached from any top segment
+            if (static_cast<int>(order_.size()) != num_seg) {
+                return false;
+            }
+
+            for (int seg = 0; seg < num_seg; ++seg) {
+                const std::size_t expected = 1 + segment_inlets[seg].size() + (outlet_[seg] >= 0 ? 1 : 0);
+                if (D.getrowsize(seg) != expected || !D.exists(seg, seg)
+                    || (outlet_[seg] >= 0 && !D.exists(seg, outlet_[seg]))) {
+                    return false;
+                }
+                // the coupling to each inlet, D[seg][inlet], is used in the elimination
+                for (const int inlet : segment_inlets[seg]) {
+                    if (!D.exists(seg, inlet)) {
+                        return false;
+                    }
+                }
+            }
+
+            invDiag_.resize(num_seg);
+            lower_.resize(num_seg);
+            upper_.resize(num_seg);
+            for (int seg = 0; seg < num_seg; ++seg) {
+                invDiag_[seg] = D[seg][seg];
+            }
+            try {
+                for (const int seg : order_) {
+                    // invDiag_ holds the Schur-complemented diagonal block until it is inverted
+                    invDiag_[seg].invert();
+                    if (!isFinite(invDiag_[seg])) {
+                        return false;
+                    }
+                    const int outlet = outlet_[seg];
+                    if (outlet >= 0) {
+                        lower_[seg] = D[outlet][seg];
+                        lower_[seg].rightmultiply(invDiag_[seg]);
+                        upper_[seg] = D[seg][outlet];
+                        Block update = lower_[seg];
+                        update.rightmultiply(upper_[seg]);
+                        invDiag_[outlet] -= update;
+                    }
+                }
+            } catch (const Dune::FMatrixError&) {
+                return false;
+            }
+
+            valid_ = true;
+            return true;
+        }
+
+        /// Whether the last factorization succeeded.
+        bool valid() const
+        {
+            return valid_;
+        }
+
+        /// Solve D y = x, overwriting x with y.
+        void solve(VectorType& x) const
+        {
+            assert(valid_);
+            // forward substitution
+            for (const int seg : order_) {
+                const int outlet = outlet_[seg];
+                if (outlet >= 0) {
+                    lower_[seg].mmv(x[seg], x[outlet]);
+                }
+            }
+            // backward substitution
+            typename VectorType::block_type rhs;
+            for (auto it = order_.rbegin(); it != order_.rend(); ++it) {
+                const int seg = *it;
+                rhs = x[seg];
+                const int outlet = outlet_[seg];
+                if (outlet >= 0) {
+                    upper_[seg].mmv(x[outlet], rhs);
+                }
+                invDiag_[seg].mv(rhs, x[seg]);
+            }
+        }
+
+    private:
+        static bool isFinite(const Block& block)
+        {
+            for (const auto& row : block) {
+                for (const auto& entry : row) {
+                    if (!std::isfinite(entry)) {
+                        return false;
+                    }
+                }
+            }
+            return true;
+        }
+
+        bool valid_ = false;
+        // the outlet of each segment, -1 for a top segment
+        std::vector<int> outlet_;
+        // segments in elimination order
+        std::vector<int> order_;
+        // inverse of the Schur-complemented diagonal blocks
+        std::vector<Block> invDiag_;
+        // D[outlet][seg] * invDiag_[seg]
+        std::vector<Block> lower_;
+        // D[seg][outlet]
+        std::vector<Block> upper_;
+    };
+
+
+
 
     template <typename ValueType>
     inline ValueType haalandFormular(const ValueType& re, const double diameter, const double roughness)
@@ -23,6 +23,7 @@
 #define OPM_MULTISEGMENTWELL_HEADER_INCLUDED
 
 #include <opm/simulators/wells/WellInterface.hpp>
+#include <opm/simulators/wells/MSWellHelpers.hpp>
 
 #include <opm/parser/eclipse/EclipseState/Runspec.hpp>
 
@@ -142,6 +143,8 @@ namespace Opm
         /// check whether the well equations get converged for this well
         virtual ConvergenceReport getWellConvergence(const WellState& well_state, const std::vector<double>& B_avg, Opm::DeferredLogger& deferred_logger, const bool relax_tolerance = false) const override;
 
+        virtual double massBalanceResidual(const std::vector<double>& B_avg) const override;
+
         /// Ax = Ax - C D^-1 B x
         virtual void apply(const BVector& x, BVector& Ax) const override;
         /// r = r - C D^-1 Rw
@@ -186,6 +189,10 @@ namespace Opm
 
         int numberOfPerforations() const;
 
+        /// The cost of the inner iterations grows with the number of
+        /// segments, which are all solved for at once.
+        virtual double solveCostEstimate() const override;
+
         virtual std::vector<double> computeCurrentWellRates(const Simulator& ebosSimulator,
                                                             DeferredLogger& deferred_logger) const override;
 
@@ -276,6 +283,14 @@ namespace Opm
         ///
         /// This is a shared_ptr as MultisegmentWell is copied in computeWellPotentials...
         mutable std::shared_ptr<Dune::UMFPack<DiagMatWell> > duneDSolver_;
+        /// \brief block LU factorization of duneD_ along the segment tree
+        mutable mswellhelpers::SegmentTreeLU<DiagMatWell, BVectorWell> duneDTreeLU_;
+        // whether duneDTreeLU_ has been computed for the current duneD_
+        mutable bool duneDTreeLUComputed_ = false;
+
+        // work vectors for apply()
+        mutable BVectorWell Bx_;
+        mutable BVectorWell invDrw_;
 
         // residuals of the well equations
         mutable BVectorWell resWell_;
@@ -334,6 +349,10 @@ namespace Opm
         // xw = inv(D)*(rw - C*x)
         void recoverSolutionWell(const BVector& x, BVectorWell& xw) const;
 
+        // x = inv(D)*x, using the segment tree factorization of D if possible
+        // and UMFPack otherwise
+        void solveDuneD(BVectorWell& x) const;
+
         // updating the well_state based on well solution dwells
         void updateWellState(const BVectorWell& dwells,
                              WellState& well_state,
@@ -228,6 +228,8 @@ namespace Opm
         }
 
         resWell_.resize( numberOfSegments() );
+        Bx_.resize( numberOfSegments() );
+        invDrw_.resize( numberOfSegments() );
 
         primary_variables_.resize(numberOfSegments());
         primary_variables_evaluation_.resize(numberOfSegments());
@@ -651,6 +653,24 @@ namespace Opm
 
 
 
+    template <typename TypeTag>
+    double
+    MultisegmentWell<TypeTag>::
+    massBalanceResidual(const std::vector<double>& B_avg) const
+    {
+        double residual = 0.0;
+        for (int seg = 0; seg < numberOfSegments(); ++seg) {
+            for (int compIdx = 0; compIdx < num_components_; ++compIdx) {
+                residual = std::max(residual, B_avg[compIdx] * std::abs(resWell_[seg][compIdx]));
+            }
+        }
+        return residual;
+    }
+
+
+
+
+
     template <typename TypeTag>
     void
     MultisegmentWell<TypeTag>::
@@ -663,12 +683,12 @@ namespace Opm
             // Contributions are already in the matrix itself
             return;
         }
-        BVectorWell Bx(duneB_.N());
+        // Bx_ = duneB_ * x
+        duneB_.mv(x, Bx_);
 
-        duneB_.mv(x, Bx);
-
-        // invDBx = duneD^-1 * Bx_
-        const BVectorWell invDBx = mswellhelpers::applyUMFPack(duneD_, duneDSolver_, Bx);
+        // invDBx = duneD^-1 * Bx_, overwriting Bx_
+        BVectorWell& invDBx = Bx_;
+        solveDuneD(invDBx);
 
         // Ax = Ax - duneC_^T * invDBx
         duneC_.mmtv(invDBx,Ax);
@@ -686,9 +706,10 @@ namespace Opm
         if (!this->isOperable() && !this->wellIsStopped()) return;
 
         // invDrw_ = duneD^-1 * resWell_
-        const BVectorWell invDrw = mswellhelpers::applyUMFPack(duneD_, duneDSolver_, resWell_);
-        // r = r - duneC_^T * invDrw
-        duneC_.mmtv(invDrw, r);
+        invDrw_ = resWell_;
+        solveDuneD(invDrw_);
+        // r = r - duneC_^T * invDrw_
+        duneC_.mmtv(invDrw_, r);
     }
 
 
@@ -861,8 +882,9 @@ namespace Opm
         MultisegmentWell<TypeTag> well_copy(*this);
         well_copy.debug_cost_counter_ = 0;
 
-        // store a copy of the well state, we don't want to update the real well state
-        WellState well_state_copy = ebosSimulator.problem().wellModel().wellState();
+        // use a trial copy of the well state, we don't want to update the real well state
+        std::optional<WellState> own_copy;
+        WellState& well_state_copy = well_copy.trialWellState(ebosSimulator.problem().wellModel().wellState(), own_copy);
 
         // Get the current controls.
         const auto& summary_state = ebosSimulator.vanguard().summaryState();
@@ -1044,11 +1066,31 @@ namespace Opm
     {
         if (!this->isOperable() && !this->wellIsStopped()) return;
 
-        BVectorWell resWell = resWell_;
-        // resWell = resWell - B * x
-        duneB_.mmv(x, resWell);
-        // xw = D^-1 * resWell
-        xw = mswellhelpers::applyUMFPack(duneD_, duneDSolver_, resWell);
+        xw = resWell_;
+        // xw = resWell - B * x
+        duneB_.mmv(x, xw);
+        // xw = D^-1 * xw
+        solveDuneD(xw);
+    }
+
+
+
+
+    template <typename TypeTag>
+    void
+    MultisegmentWell<TypeTag>::
+    solveDuneD(BVectorWell& x) const
+    {
+        if (!duneDTreeLUComputed_) {
+            duneDTreeLU_.factorize(duneD_, segment_inlets_);
+            duneDTreeLUComputed_ = true;
+        }
+
+        if (duneDTreeLU_.valid()) {
+            duneDTreeLU_.solve(x);
+        } else {
+            x = mswellhelpers::applyUMFPack(duneD_, duneDSolver_, x);
+        }
     }
 
 
@@ -1064,7 +1106,8 @@ namespace Opm
 
         // We assemble the well equations, then we check the convergence,
         // which is why we do not put the assembleWellEq here.
-        const BVectorWell dx_well = mswellhelpers::applyUMFPack(duneD_, duneDSolver_, resWell_);
+        BVectorWell dx_well = resWell_;
+        solveDuneD(dx_well);
 
         updateWellState(dx_well, well_state, deferred_logger);
     }
@@ -1366,6 +1409,18 @@ namespace Opm
 
 
 
+    template <typename TypeTag>
+    double
+    MultisegmentWell<TypeTag>::
+    solveCostEstimate() const
+    {
+        return (numberOfSegments() * numWellEq + number_of_perforations_ + 1.0) * (this->last_inner_iterations_ + 1);
+    }
+
+
+
+
+
     template <typename TypeTag>
     WellSegments::CompPressureDrop
     MultisegmentWell<TypeTag>::
@@ -2732,7 +2787,8 @@ namespace Opm
 
             assembleWellEqWithoutIteration(ebosSimulator, dt, inj_controls, prod_controls, well_state, deferred_logger);
 
-            const BVectorWell dx_well = mswellhelpers::applyUMFPack(duneD_, duneDSolver_, resWell_);
+            BVectorWell dx_well = resWell_;
+            solveDuneD(dx_well);
 
             if (it > param_.strict_inner_iter_ms_wells_)
                 relax_convergence = true;
@@ -2766,6 +2822,7 @@ namespace Opm
                             converged = true;
                             sstr << " well " << name() << " manages to get converged with relaxed tolerances in " << it << " inner iterations";
                             deferred_logger.debug(sstr.str());
+                            this->last_inner_iterations_ = it;
                             return converged;
                         }
                     }
@@ -2815,6 +2872,7 @@ namespace Opm
             deferred_logger.debug(sstr.str());
         }
 
+        this->last_inner_iterations_ = it;
         return converged;
     }
 
@@ -2849,6 +2907,7 @@ namespace Opm
         resWell_ = 0.0;
 
         duneDSolver_.reset();
+        duneDTreeLUComputed_ = false;
 
         well_state.wellVaporizedOilRates()[index_of_well_] = 0.;
         well_state.wellDissolvedGasRates()[index_of_well_] = 0.;
@@ -3623,6 +3682,15 @@ namespace Opm
             return rates;
         };
 
+        // Most of the time the intersection of the inflow line with the
+        // cached VFP curve is accurate enough, and no root finding is needed.
+        const auto bhp_from_curve = this->bhpAtThpLimitProdFromVfpCurve(frates, fbhp, controls.vfp_table_number,
+                                                                        thp_limit, controls.alq_value, dp,
+                                                                        controls.bhp_limit, 0.01 * unit::barsa);
+        if (bhp_from_curve) {
+            return bhp_from_curve;
+        }
+
         // Find the bhp-point where production becomes nonzero.
         double bhp_max = 0.0;
         {
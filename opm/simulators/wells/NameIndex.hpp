@@ -0,0 +1,104 @@
+/*
+  Copyright 2021 Equinor ASA.
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef OPM_NAMEINDEX_HEADER_INCLUDED
+#define OPM_NAMEINDEX_HEADER_INCLUDED
+
+#include <algorithm>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace Opm
+{
+
+/// Dense indices for a set of well or group names.
+///
+/// A name gets the next free index the first time it is inserted and
+/// keeps it, so data for the names can be stored in plain vectors and a
+/// name only has to be resolved once.  Besides the insertion order the
+/// indices are also available ordered by name, which gives an order that
+/// is independent of the insertion sequence, e.g. for communication.
+///
+/// Copies share the names until one of them inserts a new name, so
+/// copying an index, e.g. as part of a well state snapshot, is cheap.
+class NameIndex
+{
+public:
+    /// Index of \p name, or -1 if the name has not been inserted.
+    int index(const std::string& name) const
+    {
+        const auto it = data_->index.find(name);
+        return it == data_->index.end() ? -1 : it->second;
+    }
+
+    /// Index of \p name, inserting the name if it is not present.
+    int insert(const std::string& name)
+    {
+        const int i = index(name);
+        if (i >= 0) {
+            return i;
+        }
+
+        if (data_.use_count() > 1) {
+            data_ = std::make_shared<Data>(*data_);
+        }
+        auto& data = *data_;
+        const int new_index = data.names.size();
+        data.index.emplace(name, new_index);
+        data.names.push_back(name);
+        const auto pos = std::lower_bound(data.sorted.begin(), data.sorted.end(), name,
+                                          [&data](const int j, const std::string& n) { return data.names[j] < n; });
+        data.sorted.insert(pos, new_index);
+        return new_index;
+    }
+
+    /// Number of names.
+    int size() const
+    {
+        return data_->names.size();
+    }
+
+    /// Name with index \p i.
+    const std::string& name(const int i) const
+    {
+        return data_->names[i];
+    }
+
+    /// All indices, ordered by name.
+    const std::vector<int>& sortedIndices() const
+    {
+        return data_->sorted;
+    }
+
+private:
+    struct Data
+    {
+        std::unordered_map<std::string, int> index;
+        std::vector<std::string> names;
+        std::vector<int> sorted;
+    };
+
+    std::shared_ptr<Data> data_ = std::make_shared<Data>();
+};
+
+} // namespace Opm
+
+#endif // OPM_NAMEINDEX_HEADER_INCLUDED
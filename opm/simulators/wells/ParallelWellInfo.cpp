@@ -179,6 +179,104 @@ int GlobalPerfContainerFactory::numGlobalPerfs() const
     return num_global_perfs_;
 }
 
+GlobalPerfContainerBatch::GlobalPerfContainerBatch(const Communication& comm)
+    : comm_(comm)
+{}
+
+std::size_t GlobalPerfContainerBatch::add(const int well_index,
+                                          const ParallelWellInfo& well_info,
+                                          const std::vector<double>& local_perf_container,
+                                          const std::size_t num_components)
+{
+    const auto& factory = well_info.getGlobalPerfContainerFactory();
+    const std::size_t position = wells_.size();
+
+    if (factory.comm_.size() < 2)
+    {
+        // Nothing to exchange, the local perforations are all perforations.
+        wells_.push_back({nullptr, num_components});
+        global_.push_back(local_perf_container);
+        return position;
+    }
+
+    wells_.push_back({&factory, num_components});
+    global_.emplace_back(factory.numGlobalPerfs() * num_components, 0.0);
+    distributed_positions_.emplace(well_index, position);
+
+    send_buffer_.push_back(well_index);
+    send_buffer_.push_back(num_components);
+    const std::size_t num_perfs_pos = send_buffer_.size();
+    send_buffer_.push_back(0);
+    int num_perfs = 0;
+    for (const auto& pair: factory.local_indices_)
+    {
+        if (pair.local().attribute() == GlobalPerfContainerFactory::Attribute::owner)
+        {
+            send_buffer_.push_back(pair.global());
+            auto local_index = pair.local() * num_components;
+            for (std::size_t i = 0; i < num_components; ++i)
+                send_buffer_.push_back(local_perf_container[local_index++]);
+            ++num_perfs;
+        }
+    }
+    send_buffer_[num_perfs_pos] = num_perfs;
+    return position;
+}
+
+void GlobalPerfContainerBatch::exchange()
+{
+    if (comm_.size() < 2)
+    {
+        return;
+    }
+
+    std::vector<int> sizes(comm_.size());
+    std::vector<int> displ(comm_.size() + 1, 0);
+    int mySize = send_buffer_.size();
+    comm_.allgather(&mySize, 1, sizes.data());
+    std::partial_sum(sizes.begin(), sizes.end(), displ.begin()+1);
+    std::vector<double> recv_buffer(displ.back());
+    comm_.allgatherv(send_buffer_.data(), mySize, recv_buffer.data(), sizes.data(), displ.data());
+    send_buffer_.clear();
+
+    // Every process receives the values of all wells. Only the ones of
+    // the wells added locally are stored, including the own ones.
+    auto entry = recv_buffer.begin();
+    while (entry != recv_buffer.end())
+    {
+        const int well_index = static_cast<int>(*(entry++));
+        const auto num_components = static_cast<std::size_t>(*(entry++));
+        const int num_perfs = static_cast<int>(*(entry++));
+        const auto position = distributed_positions_.find(well_index);
+        if (position == distributed_positions_.end())
+        {
+            entry += num_perfs * (num_components + 1);
+            continue;
+        }
+
+        const auto& well = wells_[position->second];
+        assert(well.num_components == num_components);
+        const auto& perf_ecl_index = well.factory->perf_ecl_index_;
+        auto& global = global_[position->second];
+        for (int perf = 0; perf < num_perfs; ++perf)
+        {
+            const int ecl_index = static_cast<int>(*(entry++));
+            const auto global_perf = std::lower_bound(perf_ecl_index.begin(),
+                                                      perf_ecl_index.end(),
+                                                      ecl_index);
+            assert(global_perf != perf_ecl_index.end() && *global_perf == ecl_index);
+            auto global_index = (global_perf - perf_ecl_index.begin()) * num_components;
+            for (std::size_t i = 0; i < num_components; ++i)
+                global[global_index++] = *(entry++);
+        }
+    }
+}
+
+const std::vector<double>& GlobalPerfContainerBatch::global(const std::size_t position) const
+{
+    return global_[position];
+}
+
 
 CommunicateAboveBelow::CommunicateAboveBelow([[maybe_unused]] const Communication& comm)
 #if HAVE_MPI
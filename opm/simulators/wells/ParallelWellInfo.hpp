@@ -27,9 +27,11 @@
 #include <opm/common/ErrorMacros.hpp>
 #include <opm/parser/eclipse/EclipseState/Schedule/Well/Well.hpp>
 
+#include <map>
 #include <memory>
 #include <iterator>
 #include <numeric>
+#include <vector>
 
 namespace Opm
 {
@@ -227,6 +229,8 @@ public:
 
     int numGlobalPerfs() const;
 private:
+    friend class GlobalPerfContainerBatch;
+
     const IndexSet& local_indices_;
     Communication comm_;
     int num_global_perfs_;
@@ -418,6 +422,70 @@ private:
     std::unique_ptr<GlobalPerfContainerFactory> globalPerfCont_;
 };
 
+/// \brief Creates the global perforation containers of several wells with one exchange.
+///
+/// GlobalPerfContainerFactory::createGlobal needs collective operations on the
+/// communicator of the well for each well and quantity. With many distributed wells
+/// the latency of these dominates. This class gathers the local containers of all
+/// wells added on any process in a single exchange on a communicator that contains
+/// the ones of the wells, e.g. the one of the grid.
+///
+/// Usage: add() the local containers of the wells, call exchange() on all processes
+/// of the communicator, and retrieve the results with global().
+class GlobalPerfContainerBatch
+{
+public:
+    using Communication = GlobalPerfContainerFactory::Communication;
+
+    explicit GlobalPerfContainerBatch(const Communication& comm);
+
+    /// \brief Adds the values attached to the local perforations of a well.
+    /// \param well_index Index of the well that is the same on all processes,
+    ///                   e.g. Well::seqIndex().
+    /// \param well_info The parallel information of the well.
+    /// \param local_perf_container Container with values attached to the local perforations.
+    /// \param num_components the number of components per perforation.
+    /// \return The position of the well to be used with global().
+    std::size_t add(int well_index, const ParallelWellInfo& well_info,
+                    const std::vector<double>& local_perf_container,
+                    std::size_t num_components);
+
+    /// \brief Gathers the values of the wells added on all processes.
+    ///
+    /// Has to be called on all processes of the communicator, even
+    /// if no well was added locally.
+    void exchange();
+
+    /// \brief The values attached to all perforations of a well.
+    ///
+    /// Ordered like the result of GlobalPerfContainerFactory::createGlobal.
+    /// \param position The position returned by add().
+    const std::vector<double>& global(std::size_t position) const;
+
+private:
+    struct WellEntry
+    {
+        const GlobalPerfContainerFactory* factory;
+        std::size_t num_components;
+    };
+
+    Communication comm_;
+    /// \brief The wells in the order they were added.
+    ///
+    /// The factory is null for wells that are not distributed.
+    std::vector<WellEntry> wells_;
+    /// \brief The position of each distributed well by its well index.
+    std::map<int, std::size_t> distributed_positions_;
+    /// \brief The local values of the distributed wells.
+    ///
+    /// For each well the well index, the number of components, and the
+    /// number of perforations followed by the ecl index and the values
+    /// of each owned perforation. The indices are stored as doubles to
+    /// exchange everything in one message.
+    std::vector<double> send_buffer_;
+    std::vector<std::vector<double>> global_;
+};
+
 /// \brief Class checking that all connections are on active cells
 ///
 /// Works for distributed wells, too
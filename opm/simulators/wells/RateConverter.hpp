@@ -27,8 +27,15 @@
 #include <opm/simulators/linalg/ParallelIstlInformation.hpp>
 
 #include <dune/grid/common/gridenums.hh>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
 #include <algorithm>
+#include <cassert>
 #include <cmath>
+#include <cstddef>
 #include <memory>
 #include <stdexcept>
 #include <type_traits>
@@ -417,7 +424,14 @@ namespace Opm {
                 : phaseUsage_(phaseUsage)
                 , rmap_ (region)
                 , attr_ (rmap_, Attributes())
+                , cellRegionPos_(region.size(), -1)
             {
+                for (const auto& reg : rmap_.activeRegions()) {
+                    for (const auto& cell : rmap_.cells(reg)) {
+                        cellRegionPos_[cell] = regions_.size();
+                    }
+                    regions_.push_back(reg);
+                }
             }
 
 
@@ -428,98 +442,98 @@ namespace Opm {
              * state for purpose of conversion from surface rate to
              * reservoir voidage rate.
              *
+             * The cached intensive quantities of the cells are used if
+             * they are available, in which case the cells are summed in
+             * parallel.  The sums of all regions are communicated at once.
              */
             template <typename ElementContext, class EbosSimulator>
             void defineState(const EbosSimulator& simulator)
             {
-
-                // create map from cell to region
-                // and set all attributes to zero
-                for (const auto& reg : rmap_.activeRegions()) {
-                    auto& ra = attr_.attributes(reg);
-                    ra.pressure = 0.0;
-                    ra.temperature = 0.0;
-                    ra.rs = 0.0;
-                    ra.rv = 0.0;
-                    ra.pv = 0.0;
-                    ra.saltConcentration = 0.0;
-
-                }
-
-                ElementContext elemCtx( simulator );
                 const auto& gridView = simulator.gridView();
                 const auto& comm = gridView.comm();
-
-                const auto& elemEndIt = gridView.template end</*codim=*/0>();
-                for (auto elemIt = gridView.template begin</*codim=*/0>();
-                     elemIt != elemEndIt;
-                     ++elemIt)
-                {
-
-                    const auto& elem = *elemIt;
-                    if (elem.partitionType() != Dune::InteriorEntity)
-                        continue;
-
-                    elemCtx.updatePrimaryStencil(elem);
-                    elemCtx.updatePrimaryIntensiveQuantities(/*timeIdx=*/0);
-                    const unsigned cellIdx = elemCtx.globalSpaceIndex(/*spaceIdx=*/0, /*timeIdx=*/0);
-                    const auto& intQuants = elemCtx.intensiveQuantities(/*spaceIdx=*/0, /*timeIdx=*/0);
-                    const auto& fs = intQuants.fluidState();
-                    // use pore volume weighted averages.
-                    const double pv_cell =
-                            simulator.model().dofTotalVolume(cellIdx)
-                            * intQuants.porosity().value();
-
-                    // only count oil and gas filled parts of the domain
-                    double hydrocarbon = 1.0;
-                    const auto& pu = phaseUsage_;
-                    if (Details::PhaseUsed::water(pu)) {
-                        hydrocarbon -= fs.saturation(FluidSystem::waterPhaseIdx).value();
+                const auto& model = simulator.model();
+
+                // The interior cells do not change during the run.
+                if (!interiorCellsDefined_) {
+                    const auto& elemMapper = model.elementMapper();
+                    const auto& elemEndIt = gridView.template end</*codim=*/0>();
+                    for (auto elemIt = gridView.template begin</*codim=*/0>();
+                         elemIt != elemEndIt;
+                         ++elemIt)
+                    {
+                        if (elemIt->partitionType() == Dune::InteriorEntity) {
+                            interiorCells_.push_back(elemMapper.index(*elemIt));
+                        }
                     }
+                    interiorCellsDefined_ = true;
+                }
 
-                    int reg = rmap_.region(cellIdx);
-                    assert(reg >= 0);
-                    auto& ra = attr_.attributes(reg);
-                    auto& p  = ra.pressure;
-                    auto& T  = ra.temperature;
-                    auto& rs  = ra.rs;
-                    auto& rv  = ra.rv;
-                    auto& pv  = ra.pv;
-                    auto& saltConcentration = ra.saltConcentration;
-
-                    // sum p, rs, rv, and T.
-                    double hydrocarbonPV = pv_cell*hydrocarbon;
-                    if (hydrocarbonPV > 0) {
-                        pv += hydrocarbonPV;
-                        p += fs.pressure(FluidSystem::oilPhaseIdx).value()*hydrocarbonPV;
-                        rs += fs.Rs().value()*hydrocarbonPV;
-                        rv += fs.Rv().value()*hydrocarbonPV;
-                        T += fs.temperature(FluidSystem::oilPhaseIdx).value()*hydrocarbonPV;
-                        saltConcentration += fs.saltConcentration().value()*hydrocarbonPV;
+                // Hydrocarbon pore volume weighted sums of all regions.
+                std::vector<double> sums(regions_.size() * NumSums, 0.0);
+
+                const bool cached =
+                    std::all_of(interiorCells_.begin(), interiorCells_.end(),
+                                [&model](const int cellIdx)
+                                { return model.cachedIntensiveQuantities(cellIdx, /*timeIdx=*/0) != nullptr; });
+                if (cached) {
+                    // Sum over the cells in parallel with one set of sums
+                    // per thread, added up in thread order afterwards.
+                    int numThreads = 1;
+#ifdef _OPENMP
+                    numThreads = omp_get_max_threads();
+#endif
+                    std::vector<std::vector<double>> threadSums(numThreads, sums);
+                    const int numCells = interiorCells_.size();
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static) num_threads(numThreads)
+#endif
+                    for (int i = 0; i < numCells; ++i) {
+                        int threadId = 0;
+#ifdef _OPENMP
+                        threadId = omp_get_thread_num();
+#endif
+                        const int cellIdx = interiorCells_[i];
+                        addCell_(*model.cachedIntensiveQuantities(cellIdx, /*timeIdx=*/0),
+                                 model.dofTotalVolume(cellIdx), cellIdx, threadSums[threadId]);
+                    }
+                    for (const auto& threadSum : threadSums) {
+                        for (std::size_t k = 0; k < sums.size(); ++k) {
+                            sums[k] += threadSum[k];
+                        }
+                    }
+                }
+                else {
+                    ElementContext elemCtx( simulator );
+                    const auto& elemEndIt = gridView.template end</*codim=*/0>();
+                    for (auto elemIt = gridView.template begin</*codim=*/0>();
+                         elemIt != elemEndIt;
+                         ++elemIt)
+                    {
+                        const auto& elem = *elemIt;
+                        if (elem.partitionType() != Dune::InteriorEntity)
+                            continue;
+
+                        elemCtx.updatePrimaryStencil(elem);
+                        elemCtx.updatePrimaryIntensiveQuantities(/*timeIdx=*/0);
+                        const unsigned cellIdx = elemCtx.globalSpaceIndex(/*spaceIdx=*/0, /*timeIdx=*/0);
+                        addCell_(elemCtx.intensiveQuantities(/*spaceIdx=*/0, /*timeIdx=*/0),
+                                 model.dofTotalVolume(cellIdx), cellIdx, sums);
                     }
                 }
 
-                for (const auto& reg : rmap_.activeRegions()) {
-                      auto& ra = attr_.attributes(reg);
-                      auto& p  = ra.pressure;
-                      auto& T  = ra.temperature;
-                      auto& rs  = ra.rs;
-                      auto& rv  = ra.rv;
-                      auto& pv  = ra.pv;
-                      auto& saltConcentration = ra.saltConcentration;
-                      // communicate sums
-                      p = comm.sum(p);
-                      T = comm.sum(T);
-                      rs = comm.sum(rs);
-                      rv = comm.sum(rv);
-                      pv = comm.sum(pv);
-                      saltConcentration = comm.sum(saltConcentration);
-                      // compute average
-                      p /= pv;
-                      T /= pv;
-                      rs /= pv;
-                      rv /= pv;
-                      saltConcentration /=pv;
+                // communicate the sums of all regions at once
+                comm.sum(sums.data(), sums.size());
+
+                for (std::size_t pos = 0; pos < regions_.size(); ++pos) {
+                    const double* sum = &sums[pos * NumSums];
+                    auto& ra = attr_.attributes(regions_[pos]);
+                    // compute average
+                    ra.pv = sum[PoreVolume];
+                    ra.pressure = sum[Pressure] / ra.pv;
+                    ra.temperature = sum[Temperature] / ra.pv;
+                    ra.rs = sum[Rs] / ra.pv;
+                    ra.rv = sum[Rv] / ra.pv;
+                    ra.saltConcentration = sum[SaltConcentration] / ra.pv;
                 }
             }
 
@@ -770,6 +784,62 @@ namespace Opm {
 
             Details::RegionAttributes<RegionId, Attributes> attr_;
 
+            /**
+             * Active regions, and the position of the region of each
+             * cell in that list.
+             */
+            std::vector<RegionId> regions_;
+            std::vector<int> cellRegionPos_;
+
+            /**
+             * Interior cells of this process.
+             */
+            std::vector<int> interiorCells_;
+            bool interiorCellsDefined_ = false;
+
+            /**
+             * Per-region sums of the hydrocarbon pore volume weighted
+             * quantities.
+             */
+            enum { Pressure, Temperature, Rs, Rv, SaltConcentration, PoreVolume, NumSums };
+
+            /**
+             * Add the hydrocarbon pore volume weighted state of a cell to
+             * the sums of its region.
+             */
+            template <class IntensiveQuantities>
+            void addCell_(const IntensiveQuantities& intQuants,
+                          const double               totalVolume,
+                          const int                  cellIdx,
+                          std::vector<double>&       sums) const
+            {
+                const auto& fs = intQuants.fluidState();
+                // use pore volume weighted averages.
+                const double pv_cell = totalVolume * intQuants.porosity().value();
+
+                // only count oil and gas filled parts of the domain
+                double hydrocarbon = 1.0;
+                const auto& pu = phaseUsage_;
+                if (Details::PhaseUsed::water(pu)) {
+                    hydrocarbon -= fs.saturation(FluidSystem::waterPhaseIdx).value();
+                }
+
+                const int pos = cellRegionPos_[cellIdx];
+                assert(pos >= 0);
+                double* sum = &sums[pos * NumSums];
+
+                // sum p, rs, rv, and T.
+                const double hydrocarbonPV = pv_cell*hydrocarbon;
+                if (hydrocarbonPV > 0) {
+                    sum[PoreVolume] += hydrocarbonPV;
+                    sum[Pressure] += fs.pressure(FluidSystem::oilPhaseIdx).value()*hydrocarbonPV;
+                    sum[Rs] += fs.Rs().value()*hydrocarbonPV;
+                    sum[Rv] += fs.Rv().value()*hydrocarbonPV;
+                    sum[Temperature] += fs.temperature(FluidSystem::oilPhaseIdx).value()*hydrocarbonPV;
+                    sum[SaltConcentration] += fs.saltConcentration().value()*hydrocarbonPV;
+                }
+            }
+
         };
     } // namespace RateConverter
 } // namespace Opm
@@ -46,6 +46,7 @@
 #include <dune/common/dynvector.hh>
 #include <dune/common/dynmatrix.hh>
 
+#include <memory>
 #include <optional>
 #include <fmt/format.h>
 
@@ -133,16 +134,27 @@ namespace Opm
         //[A C^T    [x       =  [ res
         // B  D ]   x_well]      res_well]
 
+        // the number of well equations is only known at run-time if extra
+        // equations are added per perforation (polymer molecular weight),
+        // otherwise the blocks have a compile-time size
+        static const bool has_static_well_eq = !Base::has_polymermw;
+
         // the vector type for the res_well and x_well
-        typedef Dune::DynamicVector<Scalar> VectorBlockWellType;
+        typedef std::conditional_t<has_static_well_eq,
+                                   Dune::FieldVector<Scalar, numStaticWellEq>,
+                                   Dune::DynamicVector<Scalar>> VectorBlockWellType;
         typedef Dune::BlockVector<VectorBlockWellType> BVectorWell;
 
         // the matrix type for the diagonal matrix D
-        typedef Dune::DynamicMatrix<Scalar> DiagMatrixBlockWellType;
+        typedef std::conditional_t<has_static_well_eq,
+                                   Dune::FieldMatrix<Scalar, numStaticWellEq, numStaticWellEq>,
+                                   Dune::DynamicMatrix<Scalar>> DiagMatrixBlockWellType;
         typedef Dune::BCRSMatrix <DiagMatrixBlockWellType> DiagMatWell;
 
         // the matrix type for the non-diagonal matrix B and C^T
-        typedef Dune::DynamicMatrix<Scalar> OffDiagMatrixBlockWellType;
+        typedef std::conditional_t<has_static_well_eq,
+                                   Dune::FieldMatrix<Scalar, numStaticWellEq, numEq>,
+                                   Dune::DynamicMatrix<Scalar>> OffDiagMatrixBlockWellType;
         typedef Dune::BCRSMatrix<OffDiagMatrixBlockWellType> OffDiagMatWell;
 
         typedef DenseAd::DynamicEvaluation<Scalar, numStaticWellEq + numEq + 1> EvalWell;
@@ -191,6 +203,8 @@ namespace Opm
                                                      Opm::DeferredLogger& deferred_logger,
                                                      const bool relax_tolerance = false) const override;
 
+        virtual double massBalanceResidual(const std::vector<double>& B_avg) const override;
+
         /// Ax = Ax - C D^-1 B x
         virtual void apply(const BVector& x, BVector& Ax) const override;
         /// r = r - C D^-1 Rw
@@ -225,6 +239,24 @@ namespace Opm
                                                  const WellState& well_state,
                                                  Opm::DeferredLogger& deferred_logger) override; // should be const?
 
+        /// Stages of computeWellConnectionPressures() which let the well model
+        /// exchange the perforation values of all distributed wells at once.
+        /// Each stage adds the values of the local perforations which the next
+        /// stage needs for all perforations to a batch and returns the position
+        /// of the well in it.
+        std::size_t addPerforationPressuresAndRates(GlobalPerfContainerBatch& batch,
+                                                    const WellState& well_state) const;
+
+        std::size_t addConnectionDensities(GlobalPerfContainerBatch& batch,
+                                           const Simulator& ebosSimulator,
+                                           const WellState& well_state,
+                                           const std::vector<double>& global_press_rates);
+
+        void computeConnectionPressureDelta(const std::vector<double>& global_depth_density);
+
+        // computing the accumulation term for later use in well mass equations
+        void computeAccumWell();
+
         virtual void updateProductivityIndex(const Simulator& ebosSimulator,
                                              const WellProdIndexCalculator& wellPICalc,
                                              WellState& well_state,
@@ -259,6 +291,14 @@ namespace Opm
             DeferredLogger& deferred_logger
         ) const override;
 
+        // Set up the gas lift optimization of the well, returns nullptr if
+        // the lift gas of the well is not optimized in this Newton iteration.
+        std::unique_ptr<GasLiftHandler> initGasLiftOptimization(
+            WellState& well_state,
+            const Simulator& ebosSimulator,
+            DeferredLogger& deferred_logger
+        ) const;
+
         bool checkGliftNewtonIterationIdxOk(
             const Simulator& ebosSimulator,
             DeferredLogger& deferred_logger
@@ -383,7 +423,7 @@ namespace Opm
         DiagMatWell invDuneD_;
 
         // Wrapper for the parallel application of B for distributed wells
-        wellhelpers::ParallelStandardWellB<Scalar> parallelB_;
+        wellhelpers::ParallelStandardWellB<Scalar, OffDiagMatrixBlockWellType> parallelB_;
 
         // several vector used in the matrix calculation
         mutable BVectorWell Bx_;
@@ -430,6 +470,7 @@ namespace Opm
         // to calulate the pressure difference between well connections.
         void computePropertiesForWellConnectionPressures(const Simulator& ebosSimulator,
                                                          const WellState& well_state,
+                                                         const std::vector<double>& p_above,
                                                          std::vector<double>& b_perf,
                                                          std::vector<double>& rsmax_perf,
                                                          std::vector<double>& rvmax_perf,
@@ -437,22 +478,23 @@ namespace Opm
 
         // TODO: not total sure whether it is a good idea to put this function here
         // the major reason to put here is to avoid the usage of Wells struct
-        void computeConnectionDensities(const std::vector<double>& perfComponentRates,
+        void computeConnectionDensities(const std::vector<double>& global_perf_comp_rates,
                                         const std::vector<double>& b_perf,
                                         const std::vector<double>& rsmax_perf,
                                         const std::vector<double>& rvmax_perf,
                                         const std::vector<double>& surf_dens_perf);
 
-        void computeConnectionPressureDelta();
+        // the pressure and the component rates of the local perforations,
+        // 1 + num_components_ values per perforation
+        std::vector<double> perforationPressuresAndRates(const WellState& well_state) const;
 
-        void computeWellConnectionDensitesPressures(const WellState& well_state,
-                                                    const std::vector<double>& b_perf,
-                                                    const std::vector<double>& rsmax_perf,
-                                                    const std::vector<double>& rvmax_perf,
-                                                    const std::vector<double>& surf_dens_perf);
+        // the connection densities from the pressures and rates of all perforations
+        void computeConnectionDensities(const Simulator& ebosSimulator,
+                                        const WellState& well_state,
+                                        const std::vector<double>& global_press_rates);
 
-        // computing the accumulation term for later use in well mass equations
-        void computeAccumWell();
+        // the depth and the density of the local perforations
+        std::vector<double> perforationDepthsAndDensities() const;
 
         void computeWellConnectionPressures(const Simulator& ebosSimulator,
                                                     const WellState& well_state);
@@ -548,6 +590,11 @@ namespace Opm
         // updating the inflow based on the current reservoir condition
         virtual void updateIPR(const Simulator& ebos_simulator, Opm::DeferredLogger& deferred_logger) const override;
 
+        // the primary variables of the perforated cells, the connection
+        // pressure differences, the limits and the ALQ of the well
+        virtual std::vector<double> operabilitySignature(const Simulator& ebos_simulator,
+                                                         const WellState& well_state) const override;
+
         // for a well, when all drawdown are in the wrong direction, then this well will not
         // be able to produce/inject .
         bool allDrawDownWrongDirection(const Simulator& ebos_simulator) const;
@@ -102,8 +102,8 @@ namespace Opm
             // Add nonzeros for diagonal
             row.insert(row.index());
         }
-        // the block size is run-time determined now
-        invDuneD_[0][0].resize(numWellEq_, numWellEq_);
+        // the block size is run-time determined for some models
+        wellhelpers::resizeBlock(invDuneD_[0][0], numWellEq_, numWellEq_);
 
         for (auto row = duneB_.createbegin(), end = duneB_.createend(); row!=end; ++row) {
             for (int perf = 0 ; perf < number_of_perforations_; ++perf) {
@@ -114,8 +114,7 @@ namespace Opm
 
         for (int perf = 0 ; perf < number_of_perforations_; ++perf) {
             const int cell_idx = well_cells_[perf];
-             // the block size is run-time determined now
-             duneB_[0][cell_idx].resize(numWellEq_, numEq);
+             wellhelpers::resizeBlock(duneB_[0][cell_idx], numWellEq_, numEq);
         }
 
         // make the C^T matrix
@@ -128,22 +127,22 @@ namespace Opm
 
         for (int perf = 0; perf < number_of_perforations_; ++perf) {
             const int cell_idx = well_cells_[perf];
-            duneC_[0][cell_idx].resize(numWellEq_, numEq);
+            wellhelpers::resizeBlock(duneC_[0][cell_idx], numWellEq_, numEq);
         }
 
         resWell_.resize(1);
-        // the block size of resWell_ is also run-time determined now
-        resWell_[0].resize(numWellEq_);
+        // the block size of resWell_ is also run-time determined for some models
+        wellhelpers::resizeBlock(resWell_[0], numWellEq_);
 
         // resize temporary class variables
         Bx_.resize( duneB_.N() );
         for (unsigned i = 0; i < duneB_.N(); ++i) {
-            Bx_[i].resize(numWellEq_);
+            wellhelpers::resizeBlock(Bx_[i], numWellEq_);
         }
 
         invDrw_.resize( invDuneD_.N() );
         for (unsigned i = 0; i < invDuneD_.N(); ++i) {
-            invDrw_[i].resize(numWellEq_);
+            wellhelpers::resizeBlock(invDrw_[i], numWellEq_);
         }
     }
 
@@ -1680,6 +1679,39 @@ namespace Opm
     }
 
 
+    template<typename TypeTag>
+    std::vector<double>
+    StandardWell<TypeTag>::
+    operabilitySignature(const Simulator& ebos_simulator, const WellState& well_state) const
+    {
+        // The intensive quantities of the cells only depend on their primary
+        // variables within a time step, and the wells are created anew for
+        // every time step.
+        const auto& summaryState = ebos_simulator.vanguard().summaryState();
+        const auto& solution = ebos_simulator.model().solution(/*timeIdx=*/0);
+        std::vector<double> signature;
+        signature.reserve(4 + number_of_perforations_ * (numEq + 4));
+        signature.push_back(static_cast<int>(well_state.currentProductionControls()[index_of_well_]));
+        signature.push_back(mostStrictBhpFromBhpLimits(summaryState));
+        signature.push_back(this->wellHasTHPConstraints(summaryState) ? this->getTHPConstraint(summaryState) : 0.0);
+        signature.push_back(getALQ(well_state));
+        for (int perf = 0; perf < number_of_perforations_; ++perf) {
+            const auto& priVars = solution[well_cells_[perf]];
+            signature.push_back(static_cast<int>(priVars.primaryVarsMeaning()));
+            for (int eq = 0; eq < numEq; ++eq) {
+                signature.push_back(priVars[eq]);
+            }
+            signature.push_back(perf_pressure_diffs_[perf]);
+            signature.push_back(perf_densities_[perf]);
+            signature.push_back(well_index_[perf]);
+        }
+        return signature;
+    }
+
+
+
+
+
     template<typename TypeTag>
     void
     StandardWell<TypeTag>::
@@ -1866,6 +1898,7 @@ namespace Opm
     StandardWell<TypeTag>::
     computePropertiesForWellConnectionPressures(const Simulator& ebosSimulator,
                                                 const WellState& well_state,
+                                                const std::vector<double>& p_above,
                                                 std::vector<double>& b_perf,
                                                 std::vector<double>& rsmax_perf,
                                                 std::vector<double>& rvmax_perf,
@@ -1887,11 +1920,6 @@ namespace Opm
             rvmax_perf.resize(nperf);
         }
 
-        // Compute the average pressure in each well block
-        auto p_above =  this->parallel_well_info_.communicateAboveValues(well_state.bhp()[w],
-                                                                          well_state.perfPress().data()+first_perf_,
-                                                                          nperf);
-
         for (int perf = 0; perf < nperf; ++perf) {
             const int cell_idx = well_cells_[perf];
             const auto& intQuants = *(ebosSimulator.model().cachedIntensiveQuantities(cell_idx, /*timeIdx=*/0));
@@ -1986,7 +2014,7 @@ namespace Opm
     template<typename TypeTag>
     void
     StandardWell<TypeTag>::
-    computeConnectionDensities(const std::vector<double>& perfComponentRates,
+    computeConnectionDensities(const std::vector<double>& global_perf_comp_rates,
                                const std::vector<double>& b_perf,
                                const std::vector<double>& rsmax_perf,
                                const std::vector<double>& rvmax_perf,
@@ -2003,13 +2031,11 @@ namespace Opm
         std::vector<double> q_out_perf((nperf)*num_comp, 0.0);
 
         // Step 1 depends on the order of the perforations. Hence we need to
-        // do the modifications globally.
-        // Create and get the global perforation information and do this sequentially
-        // on each process
+        // do the modifications globally, using the rates of all perforations,
+        // and do this sequentially on each process
 
         const auto& factory = this->parallel_well_info_.getGlobalPerfContainerFactory();
-        auto global_q_out_perf = factory.createGlobal(q_out_perf, num_comp);
-        auto global_perf_comp_rates = factory.createGlobal(perfComponentRates, num_comp);
+        std::vector<double> global_q_out_perf(factory.numGlobalPerfs() * num_comp, 0.0);
 
         // TODO: investigate whether we should use the following techniques to calcuate the composition of flows in the wellbore
         // Iterate over well perforations from bottom to top.
@@ -2132,7 +2158,7 @@ namespace Opm
     template<typename TypeTag>
     void
     StandardWell<TypeTag>::
-    computeConnectionPressureDelta()
+    computeConnectionPressureDelta(const std::vector<double>& global_depth_density)
     {
         // Algorithm:
 
@@ -2148,22 +2174,30 @@ namespace Opm
         //    perforation for each well, for which it will be the
         //    difference to the reference (bhp) depth.
 
+        // 2. Compute pressure differences to the reference point (bhp) by
+        //    accumulating the already computed adjacent pressure
+        //    differences, storing the result in dp_perf.
+        //    This accumulation must be done per well.
+
+        // Both steps need the perforations of the other processes for a
+        // distributed well. Hence they use the depths and densities of all
+        // perforations and the differences are computed in the topological
+        // order on each process.
         const int nperf = number_of_perforations_;
         perf_pressure_diffs_.resize(nperf, 0.0);
-        auto z_above = this->parallel_well_info_.communicateAboveValues(ref_depth_, perf_depth_);
 
-        for (int perf = 0; perf < nperf; ++perf) {
-            const double dz = perf_depth_[perf] - z_above[perf];
-            perf_pressure_diffs_[perf] = dz * perf_densities_[perf] * gravity_;
+        const auto& factory = this->parallel_well_info_.getGlobalPerfContainerFactory();
+        std::vector<double> global_pressure_diffs(factory.numGlobalPerfs());
+        double z_above = ref_depth_;
+        double dp = 0.0;
+        for (int perf = 0; perf < factory.numGlobalPerfs(); ++perf) {
+            const double z = global_depth_density[2 * perf];
+            dp += (z - z_above) * global_depth_density[2 * perf + 1] * gravity_;
+            global_pressure_diffs[perf] = dp;
+            z_above = z;
         }
 
-        // 2. Compute pressure differences to the reference point (bhp) by
-        //    accumulating the already computed adjacent pressure
-        //    differences, storing the result in dp_perf.
-        //    This accumulation must be done per well.
-        const auto beg = perf_pressure_diffs_.begin();
-        const auto end = perf_pressure_diffs_.end();
-        this->parallel_well_info_.partialSumPerfValues(beg, end);
+        factory.copyGlobalToLocal(global_pressure_diffs, perf_pressure_diffs_, 1);
     }
 
 
@@ -2231,6 +2265,22 @@ namespace Opm
 
 
 
+    template<typename TypeTag>
+    double
+    StandardWell<TypeTag>::
+    massBalanceResidual(const std::vector<double>& B_avg) const
+    {
+        double residual = 0.0;
+        for (int compIdx = 0; compIdx < num_components_; ++compIdx) {
+            residual = std::max(residual, B_avg[compIdx] * std::abs(resWell_[0][compIdx]));
+        }
+        return residual;
+    }
+
+
+
+
+
     template<typename TypeTag>
     void
     StandardWell<TypeTag>::
@@ -2308,32 +2358,79 @@ namespace Opm
 
 
     template<typename TypeTag>
-    void
+    std::vector<double>
     StandardWell<TypeTag>::
-    computeWellConnectionDensitesPressures(const WellState& well_state,
-                                           const std::vector<double>& b_perf,
-                                           const std::vector<double>& rsmax_perf,
-                                           const std::vector<double>& rvmax_perf,
-                                           const std::vector<double>& surf_dens_perf)
+    perforationPressuresAndRates(const WellState& well_state) const
     {
-        // Compute densities
         const int nperf = number_of_perforations_;
         const int np = number_of_phases_;
-        std::vector<double> perfRates(b_perf.size(),0.0);
+        const int num_values = 1 + num_components_;
+        std::vector<double> press_rates(nperf * num_values, 0.0);
 
         for (int perf = 0; perf < nperf; ++perf) {
+            double* values = press_rates.data() + perf * num_values;
+            values[0] = well_state.perfPress()[first_perf_ + perf];
             for (int comp = 0; comp < np; ++comp) {
-                perfRates[perf * num_components_ + comp] =  well_state.perfPhaseRates()[(first_perf_ + perf) * np + ebosCompIdxToFlowCompIdx(comp)];
+                values[1 + comp] = well_state.perfPhaseRates()[(first_perf_ + perf) * np + ebosCompIdxToFlowCompIdx(comp)];
             }
             if(has_solvent) {
-                perfRates[perf * num_components_ + contiSolventEqIdx] =  well_state.perfRateSolvent()[first_perf_ + perf];
+                values[1 + contiSolventEqIdx] = well_state.perfRateSolvent()[first_perf_ + perf];
             }
         }
+        return press_rates;
+    }
+
 
-        computeConnectionDensities(perfRates, b_perf, rsmax_perf, rvmax_perf, surf_dens_perf);
 
-        computeConnectionPressureDelta();
 
+
+    template<typename TypeTag>
+    void
+    StandardWell<TypeTag>::
+    computeConnectionDensities(const Simulator& ebosSimulator,
+                               const WellState& well_state,
+                               const std::vector<double>& global_press_rates)
+    {
+        // The average pressure in each well block needs the pressure of the
+        // perforation above, the one of the first perforation is the bhp.
+        const auto& factory = this->parallel_well_info_.getGlobalPerfContainerFactory();
+        const int num_global_perfs = factory.numGlobalPerfs();
+        const int num_values = 1 + num_components_;
+        std::vector<double> global_p_above(num_global_perfs);
+        std::vector<double> global_perf_comp_rates(num_global_perfs * num_components_);
+        for (int perf = 0; perf < num_global_perfs; ++perf) {
+            global_p_above[perf] = (perf == 0) ? well_state.bhp()[index_of_well_]
+                                               : global_press_rates[(perf - 1) * num_values];
+            std::copy_n(global_press_rates.begin() + perf * num_values + 1, num_components_,
+                        global_perf_comp_rates.begin() + perf * num_components_);
+        }
+        std::vector<double> p_above(number_of_perforations_);
+        factory.copyGlobalToLocal(global_p_above, p_above, 1);
+
+        std::vector<double> b_perf;
+        std::vector<double> rsmax_perf;
+        std::vector<double> rvmax_perf;
+        std::vector<double> surf_dens_perf;
+        computePropertiesForWellConnectionPressures(ebosSimulator, well_state, p_above, b_perf, rsmax_perf, rvmax_perf, surf_dens_perf);
+        computeConnectionDensities(global_perf_comp_rates, b_perf, rsmax_perf, rvmax_perf, surf_dens_perf);
+    }
+
+
+
+
+
+    template<typename TypeTag>
+    std::vector<double>
+    StandardWell<TypeTag>::
+    perforationDepthsAndDensities() const
+    {
+        const int nperf = number_of_perforations_;
+        std::vector<double> depth_density(2 * nperf);
+        for (int perf = 0; perf < nperf; ++perf) {
+            depth_density[2 * perf] = perf_depth_[perf];
+            depth_density[2 * perf + 1] = perf_densities_[perf];
+        }
+        return depth_density;
     }
 
 
@@ -2346,15 +2443,44 @@ namespace Opm
     computeWellConnectionPressures(const Simulator& ebosSimulator,
                                    const WellState& well_state)
     {
-         // 1. Compute properties required by computeConnectionPressureDelta().
-         //    Note that some of the complexity of this part is due to the function
-         //    taking std::vector<double> arguments, and not Eigen objects.
-         std::vector<double> b_perf;
-         std::vector<double> rsmax_perf;
-         std::vector<double> rvmax_perf;
-         std::vector<double> surf_dens_perf;
-         computePropertiesForWellConnectionPressures(ebosSimulator, well_state, b_perf, rsmax_perf, rvmax_perf, surf_dens_perf);
-         computeWellConnectionDensitesPressures(well_state, b_perf, rsmax_perf, rvmax_perf, surf_dens_perf);
+        // The densities and the pressure differences both need the values of
+        // all perforations of a distributed well. BlackoilWellModel does the
+        // same for all distributed wells together, see addPerforationPressuresAndRates().
+        const auto& factory = this->parallel_well_info_.getGlobalPerfContainerFactory();
+        computeConnectionDensities(ebosSimulator, well_state,
+                                   factory.createGlobal(perforationPressuresAndRates(well_state), 1 + num_components_));
+        computeConnectionPressureDelta(factory.createGlobal(perforationDepthsAndDensities(), 2));
+    }
+
+
+
+
+
+    template<typename TypeTag>
+    std::size_t
+    StandardWell<TypeTag>::
+    addPerforationPressuresAndRates(GlobalPerfContainerBatch& batch,
+                                    const WellState& well_state) const
+    {
+        return batch.add(this->wellEcl().seqIndex(), this->parallel_well_info_,
+                         perforationPressuresAndRates(well_state), 1 + num_components_);
+    }
+
+
+
+
+
+    template<typename TypeTag>
+    std::size_t
+    StandardWell<TypeTag>::
+    addConnectionDensities(GlobalPerfContainerBatch& batch,
+                           const Simulator& ebosSimulator,
+                           const WellState& well_state,
+                           const std::vector<double>& global_press_rates)
+    {
+        computeConnectionDensities(ebosSimulator, well_state, global_press_rates);
+        return batch.add(this->wellEcl().seqIndex(), this->parallel_well_info_,
+                         perforationDepthsAndDensities(), 2);
     }
 
 
@@ -2371,7 +2497,7 @@ namespace Opm
         // We assemble the well equations, then we check the convergence,
         // which is why we do not put the assembleWellEq here.
         BVectorWell dx_well(1);
-        dx_well[0].resize(numWellEq_);
+        wellhelpers::resizeBlock(dx_well[0], numWellEq_);
         invDuneD_.mv(resWell_, dx_well);
 
         updateWellState(dx_well, well_state, deferred_logger);
@@ -2547,7 +2673,7 @@ namespace Opm
         if (!this->isOperable() && !this->wellIsStopped()) return;
 
         BVectorWell xw(1);
-        xw[0].resize(numWellEq_);
+        wellhelpers::resizeBlock(xw[0], numWellEq_);
 
         recoverSolutionWell(x, xw);
         updateWellState(xw, well_state, deferred_logger);
@@ -2605,9 +2731,9 @@ namespace Opm
     {
 
         // iterate to get a more accurate well density
-        // create a copy of the well_state to use. If the operability checking is sucessful, we use this one
-        // to replace the original one
-        WellState well_state_copy = ebosSimulator.problem().wellModel().wellState();
+        // use a trial copy of the well_state, the original one is not modified
+        std::optional<WellState> own_copy;
+        WellState& well_state_copy = this->trialWellState(ebosSimulator.problem().wellModel().wellState(), own_copy);
 
         //  Set current control to bhp, and bhp value in state, modify bhp limit in control object.
         if (well_ecl_.isInjector()) {
@@ -2829,6 +2955,20 @@ namespace Opm
                           WellState& well_state,
                           const Simulator& ebos_simulator,
                           Opm::DeferredLogger& deferred_logger) const
+    {
+        auto glift = initGasLiftOptimization(well_state, ebos_simulator, deferred_logger);
+        if (glift) {
+            glift->runOptimize();
+        }
+    }
+
+    template<typename TypeTag>
+    std::unique_ptr<typename StandardWell<TypeTag>::GasLiftHandler>
+    StandardWell<TypeTag>::
+    initGasLiftOptimization(
+                          WellState& well_state,
+                          const Simulator& ebos_simulator,
+                          Opm::DeferredLogger& deferred_logger) const
     {
         const auto& well = well_ecl_;
         if (well.isProducer()) {
@@ -2839,13 +2979,13 @@ namespace Opm
                 && current_control != Well::ProducerCMode::BHP ) {
                 if (doGasLiftOptimize(well_state, ebos_simulator, deferred_logger)) {
                     const auto& controls = well.productionControls(summary_state);
-                    GasLiftHandler glift {
+                    return std::make_unique<GasLiftHandler>(
                         *this, ebos_simulator, summary_state,
-                        deferred_logger, well_state, controls };
-                    glift.runOptimize();
+                        deferred_logger, well_state, controls);
                 }
             }
         }
+        return nullptr;
     }
 
     template<typename TypeTag>
@@ -3172,14 +3312,15 @@ namespace Opm
         // B and C have 1 row, nc colums and nonzero
         // at (0,j) only if this well has a perforation at cell j.
         typename SparseMatrixAdapter::MatrixBlock tmpMat;
-        Dune::DynamicMatrix<Scalar> tmp;
+        OffDiagMatrixBlockWellType tmp;
+        wellhelpers::resizeBlock(tmp, numWellEq_, numEq);
         for ( auto colC = duneC_[0].begin(), endC = duneC_[0].end(); colC != endC; ++colC )
         {
             const auto row_index = colC.index();
 
             for ( auto colB = duneB_[0].begin(), endB = duneB_[0].end(); colB != endB; ++colB )
             {
-                Detail::multMatrix(invDuneD_[0][0],  (*colB), tmp);
+                Detail::multMatrixImpl(invDuneD_[0][0], (*colB), tmp, std::true_type());
                 Detail::negativeMultMatrixTransposed((*colC), tmp, tmpMat);
                 jacobian.addToBlock( row_index, colB.index(), tmpMat );
             }
@@ -3743,6 +3884,15 @@ namespace Opm
             return rates;
         };
 
+        // Most of the time the intersection of the inflow line with the
+        // cached VFP curve is accurate enough, and no root finding is needed.
+        const auto bhp_from_curve = this->bhpAtThpLimitProdFromVfpCurve(frates, fbhp, controls.vfp_table_number,
+                                                                        thp_limit, alq_value, dp,
+                                                                        controls.bhp_limit, 0.01 * unit::barsa);
+        if (bhp_from_curve) {
+            return bhp_from_curve;
+        }
+
         // Get the flo samples, add extra samples at low rates and bhp
         // limit point if necessary. Then the sign must be flipped
         // since the VFP code expects that production flo values are
@@ -4110,6 +4260,7 @@ namespace Opm
             initPrimaryVariablesEvaluation();
         } while (it < max_iter);
 
+        this->last_inner_iterations_ = it;
         return converged;
     }
 
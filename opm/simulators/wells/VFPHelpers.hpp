@@ -23,6 +23,8 @@
 
 #include <opm/common/OpmLog/OpmLog.hpp>
 
+#include <algorithm>
+#include <array>
 #include <cmath>
 #include <opm/common/ErrorMacros.hpp>
 #include <opm/parser/eclipse/EclipseState/Schedule/VFPProdTable.hpp>
@@ -201,9 +203,11 @@ struct InterpData {
  * Helper function to find indices etc. for linear interpolation and extrapolation
  *  @param value_in Value to find in values
  *  @param values Sorted list of values to search for value in.
+ *  @param hint Lower index of the interval found by a previous call, which is
+ *              tried before searching, or -1. Updated with the interval found.
  *  @return Data required to find the interpolated value
  */
-inline InterpData findInterpData(const double& value_in, const std::vector<double>& values) {
+inline InterpData findInterpData(const double& value_in, const std::vector<double>& values, int& hint) {
     InterpData retval;
 
     const int nvalues = values.size();
@@ -232,15 +236,18 @@ inline InterpData findInterpData(const double& value_in, const std::vector<doubl
             retval.ind_[1] = nvalues-1;
         }
         else {
-            //Search internal intervals
-            for (int i=1; i<nvalues; ++i) {
-                if (values[i] >= value) {
-                    retval.ind_[0] = i-1;
-                    retval.ind_[1] = i;
-                    break;
-                }
+            //Search internal intervals for the first value greater than or equal to value,
+            //trying the interval of the previous evaluation first
+            int i = hint + 1;
+            const bool hint_valid = i >= 1 && i < nvalues
+                && values[i] >= value && (i == 1 || values[i-1] < value);
+            if (!hint_valid) {
+                i = std::lower_bound(values.begin() + 1, values.end(), value) - values.begin();
             }
+            retval.ind_[0] = i-1;
+            retval.ind_[1] = i;
         }
+        hint = retval.ind_[0];
 
         const double start = values[retval.ind_[0]];
         const double end   = values[retval.ind_[1]];
@@ -268,6 +275,32 @@ inline InterpData findInterpData(const double& value_in, const std::vector<doubl
     return retval;
 }
 
+/**
+ * Helper function to find indices etc. for linear interpolation and extrapolation
+ *  @param value_in Value to find in values
+ *  @param values Sorted list of values to search for value in.
+ *  @return Data required to find the interpolated value
+ */
+inline InterpData findInterpData(const double& value_in, const std::vector<double>& values) {
+    int hint = -1;
+    return findInterpData(value_in, values, hint);
+}
+
+
+
+/**
+ * Bracket hints for the axes of a VFP table, i.e. the lower indices of the
+ * intervals found in the last evaluation. Consecutive evaluations are usually
+ * close to each other and then find their intervals without searching.
+ */
+struct VFPBracketHints {
+    int flo = -1;
+    int thp = -1;
+    int wfr = -1;
+    int gfr = -1;
+    int alq = -1;
+};
+
 
 
 
@@ -444,6 +477,151 @@ inline VFPEvaluation interpolate(
 
 
 
+/**
+ * Helper function which interpolates only the value, without derivatives, using
+ * the indices etc. given in the inputs. The dimensions are removed in the same
+ * order as in interpolate(), so the value is the same.
+ */
+inline double interpolateValue(
+        const VFPProdTable& table,
+        const InterpData& flo_i,
+        const InterpData& thp_i,
+        const InterpData& wfr_i,
+        const InterpData& gfr_i,
+        const InterpData& alq_i) {
+
+    //Values in a 5D hypercube, the flo index running fastest
+    double nn[32];
+    for (int t=0; t<=1; ++t) {
+        for (int w=0; w<=1; ++w) {
+            for (int g=0; g<=1; ++g) {
+                for (int a=0; a<=1; ++a) {
+                    for (int f=0; f<=1; ++f) {
+                        nn[(((t*2 + w)*2 + g)*2 + a)*2 + f] = table(thp_i.ind_[t], wfr_i.ind_[w], gfr_i.ind_[g],
+                                                                    alq_i.ind_[a], flo_i.ind_[f]);
+                    }
+                }
+            }
+        }
+    }
+
+    // Halve the hypercube for each axis, starting with flo as in interpolate()
+    const double factors[5] = { flo_i.factor_, alq_i.factor_, gfr_i.factor_, wfr_i.factor_, thp_i.factor_ };
+    int n = 16;
+    for (const double t2 : factors) {
+        const double t1 = 1.0 - t2;
+        for (int i=0; i<n; ++i) {
+            nn[i] = t1*nn[2*i] + t2*nn[2*i+1];
+        }
+        n /= 2;
+    }
+
+    return nn[0];
+}
+
+
+
+
+
+/**
+ * Cache of the bhp(flo) curve of a production table along its flo axis,
+ * for the (thp, wfr, gfr, alq) cell of the last operating point. The table
+ * values at the 16 corners of the cell are kept for every flo sample, so the
+ * curve for another operating point in the same cell is obtained without
+ * searching or reading the table again.
+ */
+class VFPProdCurveCache {
+public:
+    /**
+     * The bhp values at the flo axis samples of the table, interpolated
+     * linearly at the given operating point.
+     */
+    const std::vector<double>& curve(const VFPProdTable& table,
+                                     const double thp,
+                                     const double wfr,
+                                     const double gfr,
+                                     const double alq)
+    {
+        const auto thp_i = findInterpData(thp, table.getTHPAxis(), hints_.thp);
+        const auto wfr_i = findInterpData(wfr, table.getWFRAxis(), hints_.wfr);
+        const auto gfr_i = findInterpData(gfr, table.getGFRAxis(), hints_.gfr);
+        const auto alq_i = findInterpData(alq, table.getALQAxis(), hints_.alq);
+        const int nflo = table.getFloAxis().size();
+
+        const bool same_cell = table_ == &table && table_num_ == table.getTableNum()
+            && cell_[0] == thp_i.ind_[0] && cell_[1] == wfr_i.ind_[0]
+            && cell_[2] == gfr_i.ind_[0] && cell_[3] == alq_i.ind_[0];
+        if (!same_cell) {
+            table_ = &table;
+            table_num_ = table.getTableNum();
+            cell_ = { thp_i.ind_[0], wfr_i.ind_[0], gfr_i.ind_[0], alq_i.ind_[0] };
+            corners_.resize(nflo);
+            for (int f=0; f<nflo; ++f) {
+                for (int t=0; t<=1; ++t) {
+                    for (int w=0; w<=1; ++w) {
+                        for (int g=0; g<=1; ++g) {
+                            for (int a=0; a<=1; ++a) {
+                                corners_[f][((t*2 + w)*2 + g)*2 + a] = table(thp_i.ind_[t], wfr_i.ind_[w],
+                                                                             gfr_i.ind_[g], alq_i.ind_[a], f);
+                            }
+                        }
+                    }
+                }
+            }
+        }
+
+        // Remove the dimensions in the same order as interpolate()
+        const double factors[4] = { alq_i.factor_, gfr_i.factor_, wfr_i.factor_, thp_i.factor_ };
+        curve_.resize(nflo);
+        for (int f=0; f<nflo; ++f) {
+            std::array<double, 16> nn = corners_[f];
+            int n = 8;
+            for (const double t2 : factors) {
+                const double t1 = 1.0 - t2;
+                for (int i=0; i<n; ++i) {
+                    nn[i] = t1*nn[2*i] + t2*nn[2*i+1];
+                }
+                n /= 2;
+            }
+            curve_[f] = nn[0];
+        }
+        return curve_;
+    }
+
+private:
+    const VFPProdTable* table_ = nullptr;
+    int table_num_ = -1;
+    std::array<int, 4> cell_ = { -1, -1, -1, -1 };
+    std::vector<std::array<double, 16>> corners_;
+    std::vector<double> curve_;
+    VFPBracketHints hints_;
+};
+
+
+
+
+
+/**
+ * This basically models interpolateValue(VFPProdTable, ...)
+ * for the 2D case of injection tables.
+ */
+inline double interpolateValue(
+        const VFPInjTable& table,
+        const InterpData& flo_i,
+        const InterpData& thp_i) {
+
+    const double t2 = flo_i.factor_;
+    const double t1 = 1.0 - t2;
+    const double v0 = t1*table(thp_i.ind_[0], flo_i.ind_[0]) + t2*table(thp_i.ind_[0], flo_i.ind_[1]);
+    const double v1 = t1*table(thp_i.ind_[1], flo_i.ind_[0]) + t2*table(thp_i.ind_[1], flo_i.ind_[1]);
+
+    return (1.0 - thp_i.factor_)*v0 + thp_i.factor_*v1;
+}
+
+
+
+
+
 /**
  * This basically models interpolate(VFPProdTable::array_type, ...)
  * which performs 5D interpolation, but here for the 2D case only
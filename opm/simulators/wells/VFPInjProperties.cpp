@@ -29,6 +29,8 @@
 
 #include <opm/simulators/wells/VFPHelpers.hpp>
 
+#include <cassert>
+
 namespace Opm {
 
 
@@ -46,6 +48,28 @@ double VFPInjProperties::bhp(int table_id,
 }
 
 
+void VFPInjProperties::bhp(int table_id,
+                           const std::vector<double>& aqua,
+                           const std::vector<double>& liquid,
+                           const std::vector<double>& vapour,
+                           const std::vector<double>& thp_arg,
+                           std::vector<double>& bhp_arg) const {
+    const VFPInjTable& table = detail::getTable(m_tables, table_id);
+    const std::size_t num_points = aqua.size();
+    assert(liquid.size() == num_points && vapour.size() == num_points
+           && thp_arg.size() == num_points);
+
+    bhp_arg.resize(num_points);
+    detail::VFPBracketHints hints;
+    for (std::size_t i = 0; i < num_points; ++i) {
+        const double flo = detail::getFlo(aqua[i], liquid[i], vapour[i], table.getFloType());
+        const auto flo_i = detail::findInterpData(flo, table.getFloAxis(), hints.flo);
+        const auto thp_i = detail::findInterpData(thp_arg[i], table.getTHPAxis(), hints.thp);
+        bhp_arg[i] = detail::interpolateValue(table, flo_i, thp_i);
+    }
+}
+
+
 double VFPInjProperties::thp(int table_id,
                              const double& aqua,
                              const double& liquid,
@@ -56,7 +80,7 @@ double VFPInjProperties::thp(int table_id,
     //Find interpolation variables
     double flo = detail::getFlo(aqua, liquid, vapour, table.getFloType());
 
-    const std::vector<double> thp_array = table.getTHPAxis();
+    const std::vector<double>& thp_array = table.getTHPAxis();
     int nthp = thp_array.size();
 
     /**
@@ -66,9 +90,10 @@ double VFPInjProperties::thp(int table_id,
      */
     auto flo_i = detail::findInterpData(flo, table.getFloAxis());
     std::vector<double> bhp_array(nthp);
+    int thp_hint = -1;
     for (int i=0; i<nthp; ++i) {
-        auto thp_i = detail::findInterpData(thp_array[i], thp_array);
-        bhp_array[i] = detail::interpolate(table, flo_i, thp_i).value;
+        auto thp_i = detail::findInterpData(thp_array[i], thp_array, thp_hint);
+        bhp_array[i] = detail::interpolateValue(table, flo_i, thp_i);
     }
 
     double retval = detail::findTHP(bhp_array, thp_array, bhp_arg);
@@ -117,6 +117,24 @@ public:
                const double& vapour,
                const double& thp) const;
 
+    /**
+     * Linear interpolation of bhp for a batch of points using the same table.
+     * Consecutive points reuse the intervals found for the previous point
+     * when possible, and no derivatives are computed.
+     * @param table_id Table number to use
+     * @param aqua Water phase, one entry per point
+     * @param liquid Oil phase, one entry per point
+     * @param vapour Gas phase, one entry per point
+     * @param thp Tubing head pressure, one entry per point
+     * @param bhp The bottom hole pressures, resized to the number of points
+     */
+    void bhp(int table_id,
+             const std::vector<double>& aqua,
+             const std::vector<double>& liquid,
+             const std::vector<double>& vapour,
+             const std::vector<double>& thp,
+             std::vector<double>& bhp) const;
+
     /**
      * Linear interpolation of thp as a function of the input parameters
      * @param table_id Table number to use
@@ -26,6 +26,8 @@
 #include <opm/material/densead/Evaluation.hpp>
 #include <opm/simulators/wells/VFPHelpers.hpp>
 
+#include <cassert>
+
 
 
 namespace Opm {
@@ -58,7 +60,7 @@ double VFPProdProperties::thp(int table_id,
         gfr = detail::getGFR(aqua, liquid, vapour, table.getGFRType());
     }
 
-    const std::vector<double> thp_array = table.getTHPAxis();
+    const std::vector<double>& thp_array = table.getTHPAxis();
     int nthp = thp_array.size();
 
     /**
@@ -71,9 +73,10 @@ double VFPProdProperties::thp(int table_id,
     auto gfr_i = detail::findInterpData( gfr, table.getGFRAxis());
     auto alq_i = detail::findInterpData( alq, table.getALQAxis());
     std::vector<double> bhp_array(nthp);
+    int thp_hint = -1;
     for (int i=0; i<nthp; ++i) {
-        auto thp_i = detail::findInterpData(thp_array[i], thp_array);
-        bhp_array[i] = detail::interpolate(table, flo_i, thp_i, wfr_i, gfr_i, alq_i).value;
+        auto thp_i = detail::findInterpData(thp_array[i], thp_array, thp_hint);
+        bhp_array[i] = detail::interpolateValue(table, flo_i, thp_i, wfr_i, gfr_i, alq_i);
     }
 
     double retval = detail::findTHP(bhp_array, thp_array, bhp_arg);
@@ -94,6 +97,74 @@ double VFPProdProperties::bhp(int table_id,
 }
 
 
+double VFPProdProperties::bhp(int table_id,
+                              const double& aqua,
+                              const double& liquid,
+                              const double& vapour,
+                              const double& thp_arg,
+                              const double& alq,
+                              std::array<double, 3>& dbhp_drates,
+                              double& dbhp_dthp) const {
+    const VFPProdTable& table = detail::getTable(m_tables, table_id);
+
+    // The rates are the variables of the evaluation, so the interpolation
+    // variables carry their derivatives with respect to the rates.
+    using Eval = DenseAd::Evaluation<double, 3>;
+    const Eval aqua_eval(aqua, 0);
+    const Eval liquid_eval(liquid, 1);
+    const Eval vapour_eval(vapour, 2);
+    const Eval flo = detail::getFlo(aqua_eval, liquid_eval, vapour_eval, table.getFloType());
+    const Eval wfr = detail::getWFR(aqua_eval, liquid_eval, vapour_eval, table.getWFRType());
+    const Eval gfr = detail::getGFR(aqua_eval, liquid_eval, vapour_eval, table.getGFRType());
+
+    // Recall that production rate is negative in Opm, so switch the sign.
+    const auto flo_i = detail::findInterpData(-flo.value(), table.getFloAxis());
+    const auto thp_i = detail::findInterpData(thp_arg, table.getTHPAxis());
+    const auto wfr_i = detail::findInterpData(wfr.value(), table.getWFRAxis());
+    const auto gfr_i = detail::findInterpData(gfr.value(), table.getGFRAxis());
+    const auto alq_i = detail::findInterpData(alq, table.getALQAxis());
+
+    const detail::VFPEvaluation bhp_val = detail::interpolate(table, flo_i, thp_i, wfr_i, gfr_i, alq_i);
+    const Eval bhp_eval = (bhp_val.dwfr * wfr) + (bhp_val.dgfr * gfr) - (bhp_val.dflo * flo);
+    for (int i = 0; i < 3; ++i) {
+        dbhp_drates[i] = bhp_eval.derivative(i);
+    }
+    dbhp_dthp = bhp_val.dthp;
+    return bhp_val.value;
+}
+
+
+void VFPProdProperties::bhp(int table_id,
+                            const std::vector<double>& aqua,
+                            const std::vector<double>& liquid,
+                            const std::vector<double>& vapour,
+                            const std::vector<double>& thp_arg,
+                            const std::vector<double>& alq,
+                            std::vector<double>& bhp_arg) const {
+    const VFPProdTable& table = detail::getTable(m_tables, table_id);
+    const std::size_t num_points = aqua.size();
+    assert(liquid.size() == num_points && vapour.size() == num_points
+           && thp_arg.size() == num_points && alq.size() == num_points);
+
+    bhp_arg.resize(num_points);
+    detail::VFPBracketHints hints;
+    for (std::size_t i = 0; i < num_points; ++i) {
+        // Recall that production rate is negative in Opm, so switch the sign.
+        const double flo = -detail::getFlo(aqua[i], liquid[i], vapour[i], table.getFloType());
+        const double wfr = detail::getWFR(aqua[i], liquid[i], vapour[i], table.getWFRType());
+        const double gfr = detail::getGFR(aqua[i], liquid[i], vapour[i], table.getGFRType());
+
+        const auto flo_i = detail::findInterpData(flo, table.getFloAxis(), hints.flo);
+        const auto thp_i = detail::findInterpData(thp_arg[i], table.getTHPAxis(), hints.thp);
+        const auto wfr_i = detail::findInterpData(wfr, table.getWFRAxis(), hints.wfr);
+        const auto gfr_i = detail::findInterpData(gfr, table.getGFRAxis(), hints.gfr);
+        const auto alq_i = detail::findInterpData(alq[i], table.getALQAxis(), hints.alq);
+
+        bhp_arg[i] = detail::interpolateValue(table, flo_i, thp_i, wfr_i, gfr_i, alq_i);
+    }
+}
+
+
 const VFPProdTable& VFPProdProperties::getTable(const int table_id) const {
     return detail::getTable(m_tables, table_id);
 }
@@ -121,13 +192,14 @@ bhpwithflo(const std::vector<double>& flos,
     const auto alq_i = detail::findInterpData( alq, table.getALQAxis()); //assume constant
 
     std::vector<double> bhps(flos.size(), 0.);
+    int flo_hint = -1;
     for (size_t i = 0; i < flos.size(); ++i) {
         // Value of FLO is negative in OPM for producers, but positive in VFP table
-        const auto flo_i = detail::findInterpData(-flos[i], table.getFloAxis());
-        const detail::VFPEvaluation bhp_val = detail::interpolate(table, flo_i, thp_i, wfr_i, gfr_i, alq_i);
+        const auto flo_i = detail::findInterpData(-flos[i], table.getFloAxis(), flo_hint);
+        const double bhp_val = detail::interpolateValue(table, flo_i, thp_i, wfr_i, gfr_i, alq_i);
 
         // TODO: this kind of breaks the conventions for the functions here by putting dp within the function
-        bhps[i] = bhp_val.value - dp;
+        bhps[i] = bhp_val - dp;
     }
 
     return bhps;
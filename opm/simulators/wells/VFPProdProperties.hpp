@@ -25,6 +25,7 @@
 #include <opm/material/densead/Evaluation.hpp>
 #include <opm/simulators/wells/VFPHelpers.hpp>
 
+#include <array>
 #include <vector>
 #include <map>
 
@@ -112,6 +113,49 @@ public:
             const double& thp,
             const double& alq) const;
 
+    /**
+     * Linear interpolation of bhp as a function of the input parameters, together
+     * with its derivatives, e.g. for Newton solves of networks of branches.
+     * @param table_id Table number to use
+     * @param aqua Water phase
+     * @param liquid Oil phase
+     * @param vapour Gas phase
+     * @param thp Tubing head pressure
+     * @param alq Artificial lift or other parameter
+     * @param dbhp_drates Derivatives of the bhp with respect to aqua, liquid and vapour
+     * @param dbhp_dthp Derivative of the bhp with respect to thp
+     *
+     * @return The bottom hole pressure, as for the function without derivatives.
+     */
+    double bhp(int table_id,
+               const double& aqua,
+               const double& liquid,
+               const double& vapour,
+               const double& thp,
+               const double& alq,
+               std::array<double, 3>& dbhp_drates,
+               double& dbhp_dthp) const;
+
+    /**
+     * Linear interpolation of bhp for a batch of points using the same table,
+     * e.g. for many rates of one well. Consecutive points reuse the intervals
+     * found for the previous point when possible, and no derivatives are computed.
+     * @param table_id Table number to use
+     * @param aqua Water phase, one entry per point
+     * @param liquid Oil phase, one entry per point
+     * @param vapour Gas phase, one entry per point
+     * @param thp Tubing head pressure, one entry per point
+     * @param alq Artificial lift or other parameter, one entry per point
+     * @param bhp The bottom hole pressures, resized to the number of points
+     */
+    void bhp(int table_id,
+             const std::vector<double>& aqua,
+             const std::vector<double>& liquid,
+             const std::vector<double>& vapour,
+             const std::vector<double>& thp,
+             const std::vector<double>& alq,
+             std::vector<double>& bhp) const;
+
     /**
      * Linear interpolation of thp as a function of the input parameters
      * @param table_id Table number to use
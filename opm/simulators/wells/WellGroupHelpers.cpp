@@ -24,7 +24,17 @@
 #include <opm/parser/eclipse/EclipseState/Schedule/Group/GConSump.hpp>
 #include <opm/parser/eclipse/EclipseState/Schedule/Group/GConSale.hpp>
 
+#include <opm/parser/eclipse/Units/Units.hpp>
+
+#include <dune/common/dynmatrix.hh>
+#include <dune/common/dynvector.hh>
+#include <dune/common/fmatrix.hh>
+
 #include <algorithm>
+#include <array>
+#include <cmath>
+#include <optional>
+#include <set>
 #include <stack>
 #include <vector>
 
@@ -105,17 +115,6 @@ namespace WellGroupHelpers
         }
     }
 
-    void accumulateGroupEfficiencyFactor(const Group& group,
-                                         const Schedule& schedule,
-                                         const int reportStepIdx,
-                                         double& factor)
-    {
-        factor *= group.getGroupEfficiencyFactor();
-        if (group.parent() != "FIELD")
-            accumulateGroupEfficiencyFactor(
-                schedule.getGroup(group.parent(), reportStepIdx), schedule, reportStepIdx, factor);
-    }
-
     double sumWellPhaseRates(const std::vector<double>& rates,
                              const Group& group,
                              const Schedule& schedule,
@@ -226,36 +225,120 @@ namespace WellGroupHelpers
         return rate;
     }
 
-    void updateGroupTargetReduction(const Group& group,
-                                    const Schedule& schedule,
-                                    const int reportStepIdx,
+    int contributingWellIndex(const GroupTree::WellNode& well,
+                              const bool injector)
+    {
+        // only count producers or injectors
+        if (well.injector != injector || well.shut)
+            return -1;
+
+        // the well is not found, or not owned.  Only sum once
+        if (!well.owned)
+            return -1;
+
+        return well.local_index;
+    }
+
+    std::vector<double> sumWellPhaseRates(const std::vector<double>& rates,
+                                          const GroupTree& tree,
+                                          const WellStateFullyImplicitBlackoil& wellState,
+                                          const bool injector)
+    {
+        const int np = wellState.numPhases();
+        std::vector<double> sums(tree.numGroups() * np, 0.0);
+        for (const auto& well : tree.wells()) {
+            const int well_index = contributingWellIndex(well, injector);
+            if (well_index < 0)
+                continue;
+
+            const double factor = injector ? well.efficiency_factor : -well.efficiency_factor;
+            for (int phase = 0; phase < np; ++phase) {
+                sums[well.group * np + phase] += factor * rates[well_index * np + phase];
+            }
+        }
+
+        // Subgroups come after their parents, so each group is complete
+        // when it is added to its parent.
+        for (int group = tree.numGroups() - 1; group > 0; --group) {
+            const int parent = tree.parent(group);
+            const double gefac = tree.groupEfficiencyFactor(group);
+            for (int phase = 0; phase < np; ++phase) {
+                sums[parent * np + phase] += gefac * sums[group * np + phase];
+            }
+        }
+        return sums;
+    }
+
+    void updateGroupTargetReduction(const GroupTree& tree,
                                     const bool isInjector,
                                     const PhaseUsage& pu,
                                     const GuideRate& guide_rate,
                                     const WellStateFullyImplicitBlackoil& wellStateNupcol,
-                                    WellStateFullyImplicitBlackoil& wellState,
-                                    std::vector<double>& groupTargetReduction)
+                                    WellStateFullyImplicitBlackoil& wellState)
     {
         const int np = wellState.numPhases();
-        for (const std::string& subGroupName : group.groups()) {
-            std::vector<double> subGroupTargetReduction(np, 0.0);
-            const Group& subGroup = schedule.getGroup(subGroupName, reportStepIdx);
-            updateGroupTargetReduction(subGroup,
-                                       schedule,
-                                       reportStepIdx,
-                                       isInjector,
-                                       pu,
-                                       guide_rate,
-                                       wellStateNupcol,
-                                       wellState,
-                                       subGroupTargetReduction);
+        const int ng = tree.numGroups();
+        std::vector<double> groupTargetReduction(ng * np, 0.0);
+
+        // the rates of subgroups under individual control, and the number
+        // of wells available for group control below each group, as
+        // counted by groupControlledWells()
+        const std::vector<double> groupRates
+            = sumWellPhaseRates(wellStateNupcol.wellRates(), tree, wellStateNupcol, isInjector);
+        std::vector<int> numGroupControlledWells(ng, 0);
+
+        for (const auto& well : tree.wells()) {
+            if (!isInjector && wellStateNupcol.isProductionGrup(well.state_index)) {
+                ++numGroupControlledWells[well.group];
+            }
+
+            const int well_index = contributingWellIndex(well, isInjector);
+            if (well_index < 0)
+                continue;
+
+            const auto wellrate_index = well_index * wellState.numPhases();
+            double* reduction = groupTargetReduction.data() + well.group * np;
+            // add contributino from wells not under group control
+            if (isInjector) {
+                if (wellState.currentInjectionControls()[well_index] != Well::InjectorCMode::GRUP)
+                    for (int phase = 0; phase < np; phase++) {
+                        reduction[phase] += wellStateNupcol.wellRates()[wellrate_index + phase] * well.efficiency_factor;
+                    }
+            } else {
+                if (wellState.currentProductionControls()[well_index] != Well::ProducerCMode::GRUP)
+                    for (int phase = 0; phase < np; phase++) {
+                        reduction[phase] -= wellStateNupcol.wellRates()[wellrate_index + phase] * well.efficiency_factor;
+                    }
+            }
+        }
+
+        // Subgroups come after their parents, so the reduction of a group
+        // is complete when the loop reaches it.
+        for (int group = ng - 1; group >= 0; --group) {
+            const std::string& groupName = tree.groupName(group);
+            const int stateGroup = tree.groupStateIndex(group);
+            double* reduction = groupTargetReduction.data() + group * np;
+            const double groupEfficiency = tree.groupEfficiencyFactor(group);
+            for (int phase = 0; phase < np; phase++) {
+                reduction[phase] *= groupEfficiency;
+            }
+            if (isInjector)
+                wellState.setCurrentInjectionGroupReductionRates(stateGroup, std::vector<double>(reduction, reduction + np));
+            else
+                wellState.setCurrentProductionGroupReductionRates(stateGroup, std::vector<double>(reduction, reduction + np));
+
+            const int parent = tree.parent(group);
+            if (parent < 0)
+                continue;
 
             // accumulate group contribution from sub group
+            double* parentReduction = groupTargetReduction.data() + parent * np;
+            const double* rates = groupRates.data() + group * np;
             if (isInjector) {
                 const Phase all[] = {Phase::WATER, Phase::OIL, Phase::GAS};
                 for (Phase phase : all) {
                     const Group::InjectionCMode& currentGroupControl
-                        = wellState.currentInjectionGroupControl(phase, subGroupName);
+                        = wellState.currentInjectionGroupControl(phase, stateGroup);
                     int phasePos;
                     if (phase == Phase::GAS && pu.phase_used[BlackoilPhases::Vapour])
                         phasePos = pu.phase_pos[BlackoilPhases::Vapour];
@@ -269,83 +352,35 @@ namespace WellGroupHelpers
                     if (currentGroupControl != Group::InjectionCMode::FLD
                         && currentGroupControl != Group::InjectionCMode::NONE) {
                         // Subgroup is under individual control.
-                        groupTargetReduction[phasePos]
-                            += sumWellRates(subGroup, schedule, wellStateNupcol, reportStepIdx, phasePos, isInjector);
+                        parentReduction[phasePos] += rates[phasePos];
                     } else {
-                        groupTargetReduction[phasePos] += subGroupTargetReduction[phasePos];
+                        parentReduction[phasePos] += reduction[phasePos];
                     }
                 }
             } else {
                 const Group::ProductionCMode& currentGroupControl
-                    = wellState.currentProductionGroupControl(subGroupName);
+                    = wellState.currentProductionGroupControl(stateGroup);
                 const bool individual_control = (currentGroupControl != Group::ProductionCMode::FLD
                                                  && currentGroupControl != Group::ProductionCMode::NONE);
-                const int num_group_controlled_wells
-                    = groupControlledWells(schedule, wellStateNupcol, reportStepIdx, subGroupName, "");
-                if (individual_control || num_group_controlled_wells == 0) {
+                const auto ctrl = wellStateNupcol.currentProductionGroupControl(stateGroup);
+                if (ctrl == Group::ProductionCMode::FLD || ctrl == Group::ProductionCMode::NONE) {
+                    numGroupControlledWells[parent] += numGroupControlledWells[group];
+                }
+                if (individual_control || numGroupControlledWells[group] == 0) {
                     for (int phase = 0; phase < np; phase++) {
-                        groupTargetReduction[phase]
-                            += sumWellRates(subGroup, schedule, wellStateNupcol, reportStepIdx, phase, isInjector);
+                        parentReduction[phase] += rates[phase];
                     }
                 } else {
                     // The subgroup may participate in group control.
-                    if (!guide_rate.has(subGroupName)) {
+                    if (!guide_rate.has(groupName)) {
                         // Accumulate from this subgroup only if no group guide rate is set for it.
                         for (int phase = 0; phase < np; phase++) {
-                            groupTargetReduction[phase] += subGroupTargetReduction[phase];
+                            parentReduction[phase] += reduction[phase];
                         }
                     }
                 }
             }
         }
-
-        for (const std::string& wellName : group.wells()) {
-            const auto& wellTmp = schedule.getWell(wellName, reportStepIdx);
-
-            if (wellTmp.isProducer() && isInjector)
-                continue;
-
-            if (wellTmp.isInjector() && !isInjector)
-                continue;
-
-            if (wellTmp.getStatus() == Well::Status::SHUT)
-                continue;
-
-            const auto& end = wellState.wellMap().end();
-            const auto& it = wellState.wellMap().find(wellName);
-            if (it == end) // the well is not found
-                continue;
-
-            int well_index = it->second[0];
-
-            if (! wellState.wellIsOwned(well_index, wellName) ) // Only sum once
-            {
-                continue;
-            }
-
-            const auto wellrate_index = well_index * wellState.numPhases();
-            const double efficiency = wellTmp.getEfficiencyFactor();
-            // add contributino from wells not under group control
-            if (isInjector) {
-                if (wellState.currentInjectionControls()[well_index] != Well::InjectorCMode::GRUP)
-                    for (int phase = 0; phase < np; phase++) {
-                        groupTargetReduction[phase] += wellStateNupcol.wellRates()[wellrate_index + phase] * efficiency;
-                    }
-            } else {
-                if (wellState.currentProductionControls()[well_index] != Well::ProducerCMode::GRUP)
-                    for (int phase = 0; phase < np; phase++) {
-                        groupTargetReduction[phase] -= wellStateNupcol.wellRates()[wellrate_index + phase] * efficiency;
-                    }
-            }
-        }
-        const double groupEfficiency = group.getGroupEfficiencyFactor();
-        for (double& elem : groupTargetReduction) {
-            elem *= groupEfficiency;
-        }
-        if (isInjector)
-            wellState.setCurrentInjectionGroupReductionRates(group.name(), groupTargetReduction);
-        else
-            wellState.setCurrentProductionGroupReductionRates(group.name(), groupTargetReduction);
     }
 
 
@@ -483,105 +518,72 @@ namespace WellGroupHelpers
     */
 
 
-    void updateVREPForGroups(const Group& group,
-                             const Schedule& schedule,
-                             const int reportStepIdx,
+    void updateVREPForGroups(const GroupTree& tree,
                              const WellStateFullyImplicitBlackoil& wellStateNupcol,
                              WellStateFullyImplicitBlackoil& wellState)
     {
-        for (const std::string& groupName : group.groups()) {
-            const Group& groupTmp = schedule.getGroup(groupName, reportStepIdx);
-            updateVREPForGroups(groupTmp, schedule, reportStepIdx, wellStateNupcol, wellState);
-        }
         const int np = wellState.numPhases();
-        double resv = 0.0;
-        for (int phase = 0; phase < np; ++phase) {
-            resv += sumWellPhaseRates(wellStateNupcol.wellReservoirRates(),
-                                      group,
-                                      schedule,
-                                      wellState,
-                                      reportStepIdx,
-                                      phase,
-                                      /*isInjector*/ false);
-        }
-        wellState.setCurrentInjectionVREPRates(group.name(), resv);
+        const std::vector<double> rates
+            = sumWellPhaseRates(wellStateNupcol.wellReservoirRates(), tree, wellState, /*isInjector*/ false);
+        for (int group = 0; group < tree.numGroups(); ++group) {
+            double resv = 0.0;
+            for (int phase = 0; phase < np; ++phase) {
+                resv += rates[group * np + phase];
+            }
+            wellState.setCurrentInjectionVREPRates(tree.groupStateIndex(group), resv);
+        }
     }
 
-    void updateReservoirRatesInjectionGroups(const Group& group,
-                                             const Schedule& schedule,
-                                             const int reportStepIdx,
+    void updateReservoirRatesInjectionGroups(const GroupTree& tree,
                                              const WellStateFullyImplicitBlackoil& wellStateNupcol,
                                              WellStateFullyImplicitBlackoil& wellState)
     {
-        for (const std::string& groupName : group.groups()) {
-            const Group& groupTmp = schedule.getGroup(groupName, reportStepIdx);
-            updateReservoirRatesInjectionGroups(groupTmp, schedule, reportStepIdx, wellStateNupcol, wellState);
-        }
         const int np = wellState.numPhases();
-        std::vector<double> resv(np, 0.0);
-        for (int phase = 0; phase < np; ++phase) {
-            resv[phase] = sumWellPhaseRates(wellStateNupcol.wellReservoirRates(),
-                                            group,
-                                            schedule,
-                                            wellState,
-                                            reportStepIdx,
-                                            phase,
-                                            /*isInjector*/ true);
+        const std::vector<double> rates
+            = sumWellPhaseRates(wellStateNupcol.wellReservoirRates(), tree, wellState, /*isInjector*/ true);
+        for (int group = 0; group < tree.numGroups(); ++group) {
+            const auto begin = rates.begin() + group * np;
+            wellState.setCurrentInjectionGroupReservoirRates(tree.groupStateIndex(group),
+                                                             std::vector<double>(begin, begin + np));
         }
-        wellState.setCurrentInjectionGroupReservoirRates(group.name(), resv);
     }
 
-    void updateWellRates(const Group& group,
-                         const Schedule& schedule,
-                         const int reportStepIdx,
+    void updateWellRates(const GroupTree& tree,
                          const WellStateFullyImplicitBlackoil& wellStateNupcol,
                          WellStateFullyImplicitBlackoil& wellState)
     {
-        for (const std::string& groupName : group.groups()) {
-            const Group& groupTmp = schedule.getGroup(groupName, reportStepIdx);
-            updateWellRates(groupTmp, schedule, reportStepIdx, wellStateNupcol, wellState);
-        }
         const int np = wellState.numPhases();
-        const auto& end = wellState.wellMap().end();
-        for (const std::string& wellName : group.wells()) {
+        for (const auto& well : tree.wells()) {
             std::vector<double> rates(np, 0.0);
-            const auto& it = wellState.wellMap().find(wellName);
-            if (it != end) { // the well is found on this node
-                int well_index = it->second[0];
-                const auto& wellTmp = schedule.getWell(wellName, reportStepIdx);
+            if (well.local_index >= 0) { // the well is found on this node
+                const int well_index = well.local_index;
                 int sign = 1;
                 // production wellRates are negative. The users of currentWellRates uses the convention in
                 // opm-common that production and injection rates are positive.
-                if (!wellTmp.isInjector())
+                if (!well.injector)
                     sign = -1;
                 for (int phase = 0; phase < np; ++phase) {
                     rates[phase] = sign * wellStateNupcol.wellRates()[well_index * np + phase];
                 }
             }
-            wellState.setCurrentWellRates(wellName, rates);
+            wellState.setCurrentWellRates(well.state_index, rates);
         }
     }
 
-    void updateGroupProductionRates(const Group& group,
-                                    const Schedule& schedule,
-                                    const int reportStepIdx,
+    void updateGroupProductionRates(const GroupTree& tree,
                                     const WellStateFullyImplicitBlackoil& wellStateNupcol,
                                     WellStateFullyImplicitBlackoil& wellState)
     {
-        for (const std::string& groupName : group.groups()) {
-            const Group& groupTmp = schedule.getGroup(groupName, reportStepIdx);
-            updateGroupProductionRates(groupTmp, schedule, reportStepIdx, wellStateNupcol, wellState);
-        }
         const int np = wellState.numPhases();
-        std::vector<double> rates(np, 0.0);
-        for (int phase = 0; phase < np; ++phase) {
-            rates[phase] = sumWellPhaseRates(
-                wellStateNupcol.wellRates(), group, schedule, wellState, reportStepIdx, phase, /*isInjector*/ false);
+        const std::vector<double> rates
+            = sumWellPhaseRates(wellStateNupcol.wellRates(), tree, wellState, /*isInjector*/ false);
+        for (int group = 0; group < tree.numGroups(); ++group) {
+            const auto begin = rates.begin() + group * np;
+            wellState.setCurrentProductionGroupRates(tree.groupStateIndex(group), std::vector<double>(begin, begin + np));
         }
-        wellState.setCurrentProductionGroupRates(group.name(), rates);
     }
 
-    void updateREINForGroups(const Group& group,
+    void updateREINForGroups(const GroupTree& tree,
                              const Schedule& schedule,
                              const int reportStepIdx,
                              const PhaseUsage& pu,
@@ -590,27 +592,24 @@ namespace WellGroupHelpers
                              WellStateFullyImplicitBlackoil& wellState)
     {
         const int np = wellState.numPhases();
-        for (const std::string& groupName : group.groups()) {
-            const Group& groupTmp = schedule.getGroup(groupName, reportStepIdx);
-            updateREINForGroups(groupTmp, schedule, reportStepIdx, pu, st, wellStateNupcol, wellState);
-        }
-
-        std::vector<double> rein(np, 0.0);
-        for (int phase = 0; phase < np; ++phase) {
-            rein[phase] = sumWellPhaseRates(
-                wellStateNupcol.wellRates(), group, schedule, wellState, reportStepIdx, phase, /*isInjector*/ false);
-        }
-
-        // add import rate and substract consumption rate for group for gas
-        if (schedule[reportStepIdx].gconsump().has(group.name())) {
-            const auto& gconsump = schedule[reportStepIdx].gconsump().get(group.name(), st);
-            if (pu.phase_used[BlackoilPhases::Vapour]) {
-                rein[pu.phase_pos[BlackoilPhases::Vapour]] += gconsump.import_rate;
-                rein[pu.phase_pos[BlackoilPhases::Vapour]] -= gconsump.consumption_rate;
+        const std::vector<double> rates
+            = sumWellPhaseRates(wellStateNupcol.wellRates(), tree, wellState, /*isInjector*/ false);
+        for (int group = 0; group < tree.numGroups(); ++group) {
+            const std::string& groupName = tree.groupName(group);
+            const auto begin = rates.begin() + group * np;
+            std::vector<double> rein(begin, begin + np);
+
+            // add import rate and substract consumption rate for group for gas
+            if (schedule[reportStepIdx].gconsump().has(groupName)) {
+                const auto& gconsump = schedule[reportStepIdx].gconsump().get(groupName, st);
+                if (pu.phase_used[BlackoilPhases::Vapour]) {
+                    rein[pu.phase_pos[BlackoilPhases::Vapour]] += gconsump.import_rate;
+                    rein[pu.phase_pos[BlackoilPhases::Vapour]] -= gconsump.consumption_rate;
+                }
             }
-        }
 
-        wellState.setCurrentInjectionREINRates(group.name(), rein);
+            wellState.setCurrentInjectionREINRates(tree.groupStateIndex(group), rein);
+        }
     }
 
 
@@ -621,7 +620,9 @@ namespace WellGroupHelpers
                             const WellStateFullyImplicitBlackoil& well_state,
                             const VFPProdProperties& vfp_prod_props,
                             const Schedule& schedule,
-                            const int report_time_step)
+                            const int report_time_step,
+                            const std::map<std::string, double>& previous_node_pressures,
+                            const std::map<std::string, std::vector<double>>& inflow_derivatives)
     {
         // TODO: Only dealing with production networks for now.
 
@@ -652,84 +653,225 @@ namespace WellGroupHelpers
         }
         assert(children.empty());
 
-        // Starting with the leaf nodes of the network, get the flow rates
-        // from the corresponding groups.
-        std::map<std::string, std::vector<double>> node_inflows;
+        // Number the nodes in that order, and look up their branches.
+        const int num_nodes = root_to_child_nodes.size();
+        std::map<std::string, int> node_index;
+        for (int i = 0; i < num_nodes; ++i) {
+            node_index[root_to_child_nodes[i]] = i;
+        }
+        std::vector<int> parent(num_nodes, -1);
+        std::vector<std::optional<double>> fixed_pressure(num_nodes);
+        std::vector<std::optional<int>> vfp_table(num_nodes);
+        for (int i = 0; i < num_nodes; ++i) {
+            const auto& node = root_to_child_nodes[i];
+            fixed_pressure[i] = network.node(node).terminal_pressure();
+            const auto upbranch = network.uptree_branch(node);
+            if (upbranch) {
+                parent[i] = node_index[(*upbranch).uptree_node()];
+                vfp_table[i] = (*upbranch).vfp_table();
+            }
+            assert(fixed_pressure[i] || parent[i] >= 0);
+        }
+
+        // Get the flow rates of the leaf nodes from the corresponding
+        // groups, and their change with the node pressure if given.
+        std::vector<std::vector<double>> leaf_inflows(num_nodes);
+        std::vector<std::vector<double>> leaf_derivatives(num_nodes);
+        std::vector<double> reference_pressure(num_nodes, 0.0);
         for (const auto& node : leaf_nodes) {
-            node_inflows[node] = well_state.currentProductionGroupRates(node);
+            const int i = node_index[node];
+            leaf_inflows[i] = well_state.currentProductionGroupRates(node);
+            assert(leaf_inflows[i].size() == 3);
             // Add the ALQ amounts to the gas rates if requested.
             if (network.node(node).add_gas_lift_gas()) {
                 const auto& group = schedule.getGroup(node, report_time_step);
                 for (const std::string& wellname : group.wells()) {
-                    node_inflows[node][BlackoilPhases::Vapour] += well_state.getALQ(wellname);
+                    leaf_inflows[i][BlackoilPhases::Vapour] += well_state.getALQ(wellname);
                 }
             }
+            const auto derivatives = inflow_derivatives.find(node);
+            const auto pressure = previous_node_pressures.find(node);
+            if (!fixed_pressure[i] && derivatives != inflow_derivatives.end()
+                && derivatives->second.size() == 3 && pressure != previous_node_pressures.end()) {
+                leaf_derivatives[i] = derivatives->second;
+                reference_pressure[i] = pressure->second;
+            }
         }
 
-        // Accumulate in the network, towards the roots. Note that a
-        // root (i.e. fixed pressure node) can still be contributing
-        // flow towards other nodes in the network, i.e.  a node is
-        // the root of a subtree.
-        auto child_to_root_nodes = root_to_child_nodes;
-        std::reverse(child_to_root_nodes.begin(), child_to_root_nodes.end());
-        for (const auto& node : child_to_root_nodes) {
-            const auto upbranch = network.uptree_branch(node);
-            if (upbranch) {
-                // Add downbranch rates to upbranch.
-                std::vector<double>& up = node_inflows[(*upbranch).uptree_node()];
-                const std::vector<double>& down = node_inflows[node];
-                if (up.empty()) {
-                    up = down;
-                } else {
-                    assert (up.size() == down.size());
-                    for (size_t ii = 0; ii < up.size(); ++ii) {
-                        up[ii] += down[ii];
+        // Node inflows for the given node pressures. The leaf inflows are
+        // linear in the leaf pressures, but never negative, and they are
+        // accumulated towards the roots. Note that a root (i.e. fixed
+        // pressure node) can still be contributing flow towards other nodes
+        // in the network, i.e. a node is the root of a subtree.
+        auto computeInflows = [&](const std::vector<double>& pressure,
+                                  std::vector<std::vector<double>>& inflows)
+        {
+            inflows.assign(num_nodes, std::vector<double>(3, 0.0));
+            for (int i = 0; i < num_nodes; ++i) {
+                if (leaf_inflows[i].empty()) {
+                    continue;
+                }
+                inflows[i] = leaf_inflows[i];
+                if (!leaf_derivatives[i].empty()) {
+                    for (int p = 0; p < 3; ++p) {
+                        inflows[i][p] += leaf_derivatives[i][p] * (pressure[i] - reference_pressure[i]);
+                        inflows[i][p] = std::max(inflows[i][p], 0.0);
                     }
                 }
             }
-        }
+            for (int i = num_nodes - 1; i >= 0; --i) {
+                if (parent[i] >= 0) {
+                    for (int p = 0; p < 3; ++p) {
+                        inflows[parent[i]][p] += inflows[i][p];
+                    }
+                }
+            }
+        };
 
         // Going the other way (from roots to leafs), calculate the pressure
-        // at each node using VFP tables and rates.
-        std::map<std::string, double> node_pressures;
-        for (const auto& node : root_to_child_nodes) {
-            auto press = network.node(node).terminal_pressure();
-            if (press) {
-                node_pressures[node] = *press;
+        // at each node using VFP tables and the current rates. Without
+        // derivatives of the inflows this is the solution.
+        std::vector<double> pressure(reference_pressure);
+        std::vector<std::vector<double>> inflows;
+        computeInflows(pressure, inflows);
+        for (int i = 0; i < num_nodes; ++i) {
+            if (fixed_pressure[i]) {
+                pressure[i] = *fixed_pressure[i];
             } else {
-                const auto upbranch = network.uptree_branch(node);
-                assert(upbranch);
-                const double up_press = node_pressures[(*upbranch).uptree_node()];
-                const auto vfp_table = (*upbranch).vfp_table();
-                if (vfp_table) {
+                const double up_press = pressure[parent[i]];
+                if (vfp_table[i]) {
                     // The rates are here positive, but the VFP code expects the
-                    // convention that production rates are negative, so we must
-                    // take a copy and flip signs.
-                    auto rates = node_inflows[node];
-                    for (auto& r : rates) { r *= -1.0; }
-                    assert(rates.size() == 3);
+                    // convention that production rates are negative.
+                    const auto& rates = inflows[i];
                     const double alq = 0.0; // TODO: Do not ignore ALQ
-                    node_pressures[node] = vfp_prod_props.bhp(*vfp_table,
-                                                              rates[BlackoilPhases::Aqua],
-                                                              rates[BlackoilPhases::Liquid],
-                                                              rates[BlackoilPhases::Vapour],
-                                                              up_press,
-                                                              alq);
+                    pressure[i] = vfp_prod_props.bhp(*vfp_table[i],
+                                                     -rates[BlackoilPhases::Aqua],
+                                                     -rates[BlackoilPhases::Liquid],
+                                                     -rates[BlackoilPhases::Vapour],
+                                                     up_press,
+                                                     alq);
 #define EXTRA_DEBUG_NETWORK 0
 #if EXTRA_DEBUG_NETWORK
                     std::ostringstream oss;
-                    oss << "parent: " << (*upbranch).uptree_node() << "  child: " << node
+                    oss << "parent: " << root_to_child_nodes[parent[i]] << "  child: " << root_to_child_nodes[i]
                         << "  rates = [ " << rates[0]*86400 << ", " << rates[1]*86400 << ", " << rates[2]*86400 << " ]"
-                        << "  p(parent) = " << up_press/1e5 << "  p(child) = " << node_pressures[node]/1e5 << std::endl;
+                        << "  p(parent) = " << up_press/1e5 << "  p(child) = " << pressure[i]/1e5 << std::endl;
                     OpmLog::debug(oss.str());
 #endif
                 } else {
                     // Table number specified as 9999 in the deck, no pressure loss.
-                    node_pressures[node] = up_press;
+                    pressure[i] = up_press;
                 }
             }
         }
 
+        // With inflows depending on the leaf pressures, solve
+        //     p_i - vfp_i(q_i(p), p_parent(i)) = 0
+        // for the pressures of the nodes without fixed pressure, where q_i is
+        // the sum of the leaf inflows below node i. The Jacobian is formed
+        // from the VFP derivatives with respect to the rates and the thp.
+        std::vector<int> unknown(num_nodes, -1);
+        int num_unknowns = 0;
+        for (int i = 0; i < num_nodes; ++i) {
+            if (!fixed_pressure[i]) {
+                unknown[i] = num_unknowns++;
+            }
+        }
+        std::vector<std::vector<int>> coupled_leaves(num_nodes);
+        for (int i = num_nodes - 1; i >= 0; --i) {
+            if (!leaf_derivatives[i].empty()) {
+                coupled_leaves[i].push_back(i);
+            }
+            if (parent[i] >= 0) {
+                auto& up = coupled_leaves[parent[i]];
+                up.insert(up.end(), coupled_leaves[i].begin(), coupled_leaves[i].end());
+            }
+        }
+        const bool coupled = std::any_of(coupled_leaves.begin(), coupled_leaves.end(),
+                                         [](const auto& leaves) { return !leaves.empty(); });
+        if (coupled) {
+            const auto single_pass_pressure = pressure;
+            const int max_iter = 20;
+            const double tolerance = 1.0e-3 * unit::barsa;
+            bool converged = false;
+            try {
+                for (int iter = 0; iter < max_iter; ++iter) {
+                    computeInflows(pressure, inflows);
+                    Dune::DynamicMatrix<double> jacobian(num_unknowns, num_unknowns, 0.0);
+                    Dune::DynamicVector<double> residual(num_unknowns, 0.0);
+                    double residual_norm = 0.0;
+                    for (int i = 0; i < num_nodes; ++i) {
+                        const int row = unknown[i];
+                        if (row < 0) {
+                            continue;
+                        }
+                        const int up = parent[i];
+                        jacobian[row][row] = 1.0;
+                        if (vfp_table[i]) {
+                            const auto& rates = inflows[i];
+                            std::array<double, 3> dbhp_drates;
+                            double dbhp_dthp = 0.0;
+                            const double alq = 0.0; // TODO: Do not ignore ALQ
+                            const double bhp = vfp_prod_props.bhp(*vfp_table[i],
+                                                                  -rates[BlackoilPhases::Aqua],
+                                                                  -rates[BlackoilPhases::Liquid],
+                                                                  -rates[BlackoilPhases::Vapour],
+                                                                  pressure[up],
+                                                                  alq,
+                                                                  dbhp_drates,
+                                                                  dbhp_dthp);
+                            residual[row] = pressure[i] - bhp;
+                            if (unknown[up] >= 0) {
+                                jacobian[row][unknown[up]] -= dbhp_dthp;
+                            }
+                            for (const int leaf : coupled_leaves[i]) {
+                                double dbhp_dleaf = 0.0;
+                                for (int p = 0; p < 3; ++p) {
+                                    const double dq = leaf_derivatives[leaf][p];
+                                    const double q = leaf_inflows[leaf][p] + dq * (pressure[leaf] - reference_pressure[leaf]);
+                                    if (q > 0.0) {
+                                        // the rates are negated for the VFP lookup
+                                        dbhp_dleaf -= dbhp_drates[p] * dq;
+                                    }
+                                }
+                                jacobian[row][unknown[leaf]] -= dbhp_dleaf;
+                            }
+                        } else {
+                            residual[row] = pressure[i] - pressure[up];
+                            if (unknown[up] >= 0) {
+                                jacobian[row][unknown[up]] -= 1.0;
+                            }
+                        }
+                        residual_norm = std::max(residual_norm, std::abs(residual[row]));
+                    }
+                    if (residual_norm < tolerance) {
+                        converged = true;
+                        break;
+                    }
+                    Dune::DynamicVector<double> update(num_unknowns, 0.0);
+                    jacobian.solve(update, residual);
+                    for (int i = 0; i < num_nodes; ++i) {
+                        if (unknown[i] >= 0) {
+                            pressure[i] -= update[unknown[i]];
+                        }
+                    }
+                }
+            } catch (const Dune::FMatrixError&) {
+                converged = false;
+            }
+            const bool physical = std::all_of(pressure.begin(), pressure.end(),
+                                              [](const double p) { return std::isfinite(p) && p > 0.0; });
+            if (!converged || !physical) {
+                // Keep the pressures of the current inflows, the coupling is
+                // then resolved over the outer iterations as before.
+                pressure = single_pass_pressure;
+            }
+        }
+
+        std::map<std::string, double> node_pressures;
+        for (int i = 0; i < num_nodes; ++i) {
+            node_pressures[root_to_child_nodes[i]] = pressure[i];
+        }
         return node_pressures;
     }
 
@@ -26,11 +26,13 @@
 #include <opm/parser/eclipse/EclipseState/Schedule/Schedule.hpp>
 #include <opm/simulators/utils/DeferredLogger.hpp>
 #include <opm/simulators/utils/DeferredLoggingErrorHelpers.hpp>
+#include <opm/simulators/wells/GroupTree.hpp>
 #include <opm/simulators/wells/VFPProdProperties.hpp>
 #include <opm/simulators/wells/WellStateFullyImplicitBlackoil.hpp>
 
 #include <algorithm>
 #include <cassert>
+#include <cstddef>
 #include <map>
 #include <string>
 #include <type_traits>
@@ -51,11 +53,6 @@ namespace WellGroupHelpers
                        const int reportStepIdx,
                        WellStateFullyImplicitBlackoil& wellState);
 
-    void accumulateGroupEfficiencyFactor(const Group& group,
-                                         const Schedule& schedule,
-                                         const int reportStepIdx,
-                                         double& factor);
-
     double sumWellPhaseRates(const std::vector<double>& rates,
                              const Group& group,
                              const Schedule& schedule,
@@ -84,120 +81,106 @@ namespace WellGroupHelpers
                            const int reportStepIdx,
                            const bool injector);
 
-    void updateGroupTargetReduction(const Group& group,
-                                    const Schedule& schedule,
-                                    const int reportStepIdx,
+    /// Index of the well in the local wells if its rates contribute to
+    /// the group sums on this process, and -1 otherwise.  Wells contribute
+    /// if they are injectors or producers according to \p injector, are
+    /// not shut, are present on and owned by this process, as resolved by
+    /// GroupTree::resolveStateIndices().
+    int contributingWellIndex(const GroupTree::WellNode& well,
+                              const bool injector);
+
+    /// The sums computed by sumWellPhaseRates() for all groups of \p tree
+    /// and all phases, in one bottom-up pass.  Entry group * np + phase
+    /// holds the sum of phase for the group with index group in the tree.
+    std::vector<double> sumWellPhaseRates(const std::vector<double>& rates,
+                                          const GroupTree& tree,
+                                          const WellStateFullyImplicitBlackoil& wellState,
+                                          const bool injector);
+
+    void updateGroupTargetReduction(const GroupTree& tree,
                                     const bool isInjector,
                                     const PhaseUsage& pu,
                                     const GuideRate& guide_rate,
                                     const WellStateFullyImplicitBlackoil& wellStateNupcol,
-                                    WellStateFullyImplicitBlackoil& wellState,
-                                    std::vector<double>& groupTargetReduction);
+                                    WellStateFullyImplicitBlackoil& wellState);
 
     template <class Comm>
-    void updateGuideRateForGroups(const Group& group,
-                                  const Schedule& schedule,
+    void updateGuideRateForGroups(const GroupTree& tree,
                                   const PhaseUsage& pu,
                                   const int reportStepIdx,
                                   const double& simTime,
                                   const bool isInjector,
                                   WellStateFullyImplicitBlackoil& wellState,
                                   const Comm& comm,
-                                  GuideRate* guideRate,
-                                  std::vector<double>& pot)
+                                  GuideRate* guideRate)
     {
         const int np = pu.num_phases;
-        for (const std::string& groupName : group.groups()) {
-            std::vector<double> thisPot(np, 0.0);
-            const Group& groupTmp = schedule.getGroup(groupName, reportStepIdx);
-            updateGuideRateForGroups(
-                groupTmp, schedule, pu, reportStepIdx, simTime, isInjector, wellState, comm, guideRate, thisPot);
-
-            const auto gefac = groupTmp.getGroupEfficiencyFactor();
-
-            // accumulate group contribution from sub group unconditionally
-            if (isInjector) {
-                const Phase all[] = {Phase::WATER, Phase::OIL, Phase::GAS};
-                for (Phase phase : all) {
-                    int phasePos;
-                    if (phase == Phase::GAS && pu.phase_used[BlackoilPhases::Vapour])
-                        phasePos = pu.phase_pos[BlackoilPhases::Vapour];
-                    else if (phase == Phase::OIL && pu.phase_used[BlackoilPhases::Liquid])
-                        phasePos = pu.phase_pos[BlackoilPhases::Liquid];
-                    else if (phase == Phase::WATER && pu.phase_used[BlackoilPhases::Aqua])
-                        phasePos = pu.phase_pos[BlackoilPhases::Aqua];
-                    else
-                        continue;
-
-                    pot[phasePos] += gefac * thisPot[phasePos];
-                }
-            } else {
-                const Group::ProductionCMode& currentGroupControl = wellState.currentProductionGroupControl(groupName);
-                if (currentGroupControl != Group::ProductionCMode::FLD
-                    && currentGroupControl != Group::ProductionCMode::NONE) {
-                    continue;
-                }
-                for (int phase = 0; phase < np; phase++) {
-                    pot[phase] += gefac * thisPot[phase];
-                }
-            }
-        }
-        for (const std::string& wellName : group.wells()) {
-            const auto& wellTmp = schedule.getWell(wellName, reportStepIdx);
-            const auto wefac = wellTmp.getEfficiencyFactor();
+        const int ng = tree.numGroups();
+        std::vector<double> pot(ng * np, 0.0);
 
-            if (wellTmp.isProducer() && isInjector)
+        // add contribution from wells unconditionally
+        for (const auto& well : tree.wells()) {
+            const int well_index = contributingWellIndex(well, isInjector);
+            if (well_index < 0)
                 continue;
 
-            if (wellTmp.isInjector() && !isInjector)
-                continue;
-
-            if (wellTmp.getStatus() == Well::Status::SHUT)
-                continue;
-            const auto& end = wellState.wellMap().end();
-            const auto& it = wellState.wellMap().find(wellName);
-            if (it == end) // the well is not found
-                continue;
-
-            int well_index = it->second[0];
-
-            if (! wellState.wellIsOwned(well_index, wellName) ) // Only sum once
-            {
-                continue;
+            const auto wpot = wellState.wellPotentials().data() + well_index * wellState.numPhases();
+            for (int phase = 0; phase < np; phase++) {
+                pot[well.group * np + phase] += well.efficiency_factor * wpot[phase];
             }
+        }
 
-            const auto wellrate_index = well_index * wellState.numPhases();
-            // add contribution from wells unconditionally
+        // accumulate group contribution from sub groups, producer groups
+        // only if they are available for group control
+        for (int group = ng - 1; group > 0; --group) {
+            if (!isInjector) {
+                const Group::ProductionCMode& currentGroupControl
+                    = wellState.currentProductionGroupControl(tree.groupStateIndex(group));
+                if (currentGroupControl != Group::ProductionCMode::FLD
+                    && currentGroupControl != Group::ProductionCMode::NONE) {
+                    continue;
+                }
+            }
+            const int parent = tree.parent(group);
+            const double gefac = tree.groupEfficiencyFactor(group);
             for (int phase = 0; phase < np; phase++) {
-                pot[phase] += wefac * wellState.wellPotentials()[wellrate_index + phase];
+                pot[parent * np + phase] += gefac * pot[group * np + phase];
             }
         }
 
-        double oilPot = 0.0;
-        if (pu.phase_used[BlackoilPhases::Liquid])
-            oilPot = pot[pu.phase_pos[BlackoilPhases::Liquid]];
+        if (isInjector) {
+            // The injection potentials are stored as the local sums.
+            for (int group = ng - 1; group >= 0; --group) {
+                const auto begin = pot.begin() + group * np;
+                wellState.setCurrentGroupInjectionPotentials(tree.groupStateIndex(group),
+                                                             std::vector<double>(begin, begin + np));
+            }
+            return;
+        }
 
-        double gasPot = 0.0;
-        if (pu.phase_used[BlackoilPhases::Vapour])
-            gasPot = pot[pu.phase_pos[BlackoilPhases::Vapour]];
+        // The guide rates need the global potentials, summed for all
+        // groups in one reduction.
+        std::vector<double> globalPot(3 * ng, 0.0);
+        for (int group = 0; group < ng; ++group) {
+            if (pu.phase_used[BlackoilPhases::Liquid])
+                globalPot[3 * group + 0] = pot[group * np + pu.phase_pos[BlackoilPhases::Liquid]];
 
-        double waterPot = 0.0;
-        if (pu.phase_used[BlackoilPhases::Aqua])
-            waterPot = pot[pu.phase_pos[BlackoilPhases::Aqua]];
+            if (pu.phase_used[BlackoilPhases::Vapour])
+                globalPot[3 * group + 1] = pot[group * np + pu.phase_pos[BlackoilPhases::Vapour]];
 
-        oilPot = comm.sum(oilPot);
-        gasPot = comm.sum(gasPot);
-        waterPot = comm.sum(waterPot);
+            if (pu.phase_used[BlackoilPhases::Aqua])
+                globalPot[3 * group + 2] = pot[group * np + pu.phase_pos[BlackoilPhases::Aqua]];
+        }
+        comm.sum(globalPot.data(), globalPot.size());
 
-        if (isInjector) {
-            wellState.setCurrentGroupInjectionPotentials(group.name(), pot);
-        } else {
-            guideRate->compute(group.name(), reportStepIdx, simTime, oilPot, gasPot, waterPot);
+        for (int group = ng - 1; group >= 0; --group) {
+            guideRate->compute(tree.groupName(group), reportStepIdx, simTime,
+                               globalPot[3 * group + 0], globalPot[3 * group + 1], globalPot[3 * group + 2]);
         }
     }
 
     template <class Comm>
-    void updateGuideRatesForWells(const Schedule& schedule,
+    void updateGuideRatesForWells(const GroupTree& tree,
                                   const PhaseUsage& pu,
                                   const int reportStepIdx,
                                   const double& simTime,
@@ -205,62 +188,50 @@ namespace WellGroupHelpers
                                   const Comm& comm,
                                   GuideRate* guideRate)
     {
-
-        const auto& end = wellState.wellMap().end();
-        for (const auto& well : schedule.getWells(reportStepIdx)) {
-            double oilpot = 0.0;
-            double gaspot = 0.0;
-            double waterpot = 0.0;
-
-            const auto& it = wellState.wellMap().find(well.name());
-            if (it != end && wellState.wellIsOwned(it->second[0], well.name()))
+        const auto& wells = tree.wells();
+        std::vector<double> pot(3 * wells.size(), 0.0);
+        for (std::size_t w = 0; w < wells.size(); ++w) {
+            if (wells[w].owned)
             {
                 // the well is found and owned
-                int well_index = it->second[0];
+                const int well_index = wells[w].local_index;
 
                 const auto wpot = wellState.wellPotentials().data() + well_index * wellState.numPhases();
                 if (pu.phase_used[BlackoilPhases::Liquid] > 0)
-                    oilpot = wpot[pu.phase_pos[BlackoilPhases::Liquid]];
+                    pot[3 * w + 0] = wpot[pu.phase_pos[BlackoilPhases::Liquid]];
 
                 if (pu.phase_used[BlackoilPhases::Vapour] > 0)
-                    gaspot = wpot[pu.phase_pos[BlackoilPhases::Vapour]];
+                    pot[3 * w + 1] = wpot[pu.phase_pos[BlackoilPhases::Vapour]];
 
                 if (pu.phase_used[BlackoilPhases::Aqua] > 0)
-                    waterpot = wpot[pu.phase_pos[BlackoilPhases::Aqua]];
+                    pot[3 * w + 2] = wpot[pu.phase_pos[BlackoilPhases::Aqua]];
             }
-            oilpot = comm.sum(oilpot);
-            gaspot = comm.sum(gaspot);
-            waterpot = comm.sum(waterpot);
-            guideRate->compute(well.name(), reportStepIdx, simTime, oilpot, gaspot, waterpot);
+        }
+        comm.sum(pot.data(), pot.size());
+
+        for (std::size_t w = 0; w < wells.size(); ++w) {
+            guideRate->compute(wells[w].name, reportStepIdx, simTime, pot[3 * w + 0], pot[3 * w + 1], pot[3 * w + 2]);
         }
     }
 
 
-    void updateVREPForGroups(const Group& group,
-                             const Schedule& schedule,
-                             const int reportStepIdx,
+    void updateVREPForGroups(const GroupTree& tree,
                              const WellStateFullyImplicitBlackoil& wellStateNupcol,
                              WellStateFullyImplicitBlackoil& wellState);
 
-    void updateReservoirRatesInjectionGroups(const Group& group,
-                                             const Schedule& schedule,
-                                             const int reportStepIdx,
+    void updateReservoirRatesInjectionGroups(const GroupTree& tree,
                                              const WellStateFullyImplicitBlackoil& wellStateNupcol,
                                              WellStateFullyImplicitBlackoil& wellState);
 
-    void updateWellRates(const Group& group,
-                         const Schedule& schedule,
-                         const int reportStepIdx,
+    void updateWellRates(const GroupTree& tree,
                          const WellStateFullyImplicitBlackoil& wellStateNupcol,
                          WellStateFullyImplicitBlackoil& wellState);
 
-    void updateGroupProductionRates(const Group& group,
-                                    const Schedule& schedule,
-                                    const int reportStepIdx,
+    void updateGroupProductionRates(const GroupTree& tree,
                                     const WellStateFullyImplicitBlackoil& wellStateNupcol,
                                     WellStateFullyImplicitBlackoil& wellState);
 
-    void updateREINForGroups(const Group& group,
+    void updateREINForGroups(const GroupTree& tree,
                              const Schedule& schedule,
                              const int reportStepIdx,
                              const PhaseUsage& pu,
@@ -268,12 +239,20 @@ namespace WellGroupHelpers
                              const WellStateFullyImplicitBlackoil& wellStateNupcol,
                              WellStateFullyImplicitBlackoil& wellState);
 
+    // Node pressures of the production network. The inflow of a leaf node
+    // is the production of its group, which changes with the node pressure
+    // by inflow_derivatives (per phase) around previous_node_pressures. With
+    // such derivatives the node pressures and the inflows are solved for
+    // together with Newton's method, otherwise the pressures follow from the
+    // current inflows in a single pass.
     std::map<std::string, double>
     computeNetworkPressures(const Opm::Network::ExtNetwork& network,
                             const WellStateFullyImplicitBlackoil& well_state,
                             const VFPProdProperties& vfp_prod_props,
                             const Schedule& schedule,
-                            const int report_time_step);
+                            const int report_time_step,
+                            const std::map<std::string, double>& previous_node_pressures = {},
+                            const std::map<std::string, std::vector<double>>& inflow_derivatives = {});
 
     GuideRate::RateVector
     getRateVector(const WellStateFullyImplicitBlackoil& well_state, const PhaseUsage& pu, const std::string& name);
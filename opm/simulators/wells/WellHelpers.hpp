@@ -28,8 +28,13 @@
 
 #include <dune/istl/bcrsmatrix.hh>
 #include <dune/common/dynmatrix.hh>
+#include <dune/common/dynvector.hh>
+#include <dune/common/fmatrix.hh>
+#include <dune/common/fvector.hh>
 #include <dune/common/parallel/mpihelper.hh>
 
+#include <algorithm>
+#include <cassert>
 #include <vector>
 
 namespace Opm {
@@ -50,11 +55,11 @@ namespace Opm {
         /// matrix interface.
         ///
         /// \tparam Scalar The scalar used for the computation.
-        template<typename Scalar>
+        /// \tparam Block The type of the blocks of B.
+        template<typename Scalar, typename Block = Dune::DynamicMatrix<Scalar>>
         class ParallelStandardWellB
         {
         public:
-            using Block = Dune::DynamicMatrix<Scalar>;
             using Matrix = Dune::BCRSMatrix<Block>;
 
             ParallelStandardWellB(const Matrix& B, const ParallelWellInfo& parallel_well_info)
@@ -114,8 +119,8 @@ namespace Opm {
                     // broadcast when applying C^T.
                     using YField = typename Y::block_type::value_type;
                     assert(y.size() == 1);
-                    this->parallel_well_info_->communication().template allreduce<std::plus<YField>>(y[0].container().data(),
-                                                                                                     y[0].container().size());
+                    this->parallel_well_info_->communication().template allreduce<std::plus<YField>>(&y[0][0],
+                                                                                                     y[0].size());
                 }
             }
 
@@ -142,6 +147,36 @@ namespace Opm {
             const ParallelWellInfo* parallel_well_info_;
         };
 
+        /// \brief Sets the size of a block of the well matrices.
+        ///
+        /// Blocks with a compile-time size keep their size, which has to
+        /// match the requested one.
+        template<typename Scalar>
+        void resizeBlock(Dune::DynamicMatrix<Scalar>& block, const int rows, const int cols)
+        {
+            block.resize(rows, cols);
+        }
+
+        template<typename Scalar, int n, int m>
+        void resizeBlock(Dune::FieldMatrix<Scalar, n, m>& /* block */,
+                         [[maybe_unused]] const int rows, [[maybe_unused]] const int cols)
+        {
+            assert(rows == n && cols == m);
+        }
+
+        /// \brief Sets the size of a block of the well vectors.
+        template<typename Scalar>
+        void resizeBlock(Dune::DynamicVector<Scalar>& block, const int size)
+        {
+            block.resize(size);
+        }
+
+        template<typename Scalar, int n>
+        void resizeBlock(Dune::FieldVector<Scalar, n>& /* block */, [[maybe_unused]] const int size)
+        {
+            assert(size == n);
+        }
+
         inline
         double computeHydrostaticCorrection(const double well_ref_depth, const double vfp_ref_depth,
                                             const double rho, const double gravity) {
@@ -154,8 +189,8 @@ namespace Opm {
 
 
         /// \brief Sums entries of the diagonal Matrix for distributed wells
-        template<typename Scalar, typename Comm>
-        void sumDistributedWellEntries(Dune::DynamicMatrix<Scalar>& mat, Dune::DynamicVector<Scalar>& vec,
+        template<typename Matrix, typename Vector, typename Comm>
+        void sumDistributedWellEntries(Matrix& mat, Vector& vec,
                                        const Comm& comm)
         {
             // DynamicMatrix does not use one contiguous array for storing the data
@@ -165,6 +200,7 @@ namespace Opm {
             {
                 return;
             }
+            using Scalar = typename Matrix::field_type;
             std::vector<Scalar> allEntries;
             allEntries.reserve(mat.N()*mat.M()+vec.size());
             for(const auto& row: mat)
@@ -174,7 +210,7 @@ namespace Opm {
             allEntries.insert(allEntries.end(), vec.begin(), vec.end());
             comm.sum(allEntries.data(), allEntries.size());
             auto pos = allEntries.begin();
-            auto cols = mat.cols();
+            auto cols = mat.M();
             for(auto&& row: mat)
             {
                 std::copy(pos, pos + cols, &(row[0]));
@@ -53,8 +53,12 @@
 #include <opm/material/densead/Math.hpp>
 #include <opm/material/densead/Evaluation.hpp>
 
+#include <algorithm>
+#include <array>
 #include <string>
 #include <memory>
+#include <optional>
+#include <utility>
 #include <vector>
 #include <cassert>
 
@@ -152,6 +156,9 @@ namespace Opm
         /// Well cells.
         const std::vector<int>& cells() const {return well_cells_; }
 
+        /// Information about the processes sharing the well.
+        const ParallelWellInfo& parallelWellInfo() const { return parallel_well_info_; }
+
         void setVFPProperties(const VFPProperties* vfp_properties_arg);
 
         void setGuideRate(const GuideRate* guide_rate_arg);
@@ -166,6 +173,10 @@ namespace Opm
 
         virtual ConvergenceReport getWellConvergence(const WellState& well_state, const std::vector<double>& B_avg, Opm::DeferredLogger& deferred_logger, const bool relax_tolerance = false) const = 0;
 
+        /// Largest residual of the mass balance equations of the well,
+        /// scaled with B_avg as in getWellConvergence().
+        virtual double massBalanceResidual(const std::vector<double>& B_avg) const = 0;
+
         virtual void solveEqAndUpdateWellState(WellState& well_state, Opm::DeferredLogger& deferred_logger) = 0;
 
         virtual void assembleWellEq(const Simulator& ebosSimulator,
@@ -175,6 +186,15 @@ namespace Opm
                                     Opm::DeferredLogger& deferred_logger
                                     ) = 0;
 
+        /// Estimated cost of solving the equations of the well, from the
+        /// number of perforations and the number of inner iterations of the
+        /// last solve. Used to start the most expensive wells first when
+        /// the wells are solved concurrently.
+        virtual double solveCostEstimate() const
+        {
+            return (number_of_perforations_ + 1.0) * (last_inner_iterations_ + 1);
+        }
+
         virtual void maybeDoGasLiftOptimization (
             WellState& well_state,
             const Simulator& ebosSimulator,
@@ -210,6 +230,11 @@ namespace Opm
                                            std::vector<double>& well_potentials,
                                            Opm::DeferredLogger& deferred_logger) = 0;
 
+        /// Lend the well a scratch copy of the well state for the trial solutions
+        /// done while computing well potentials, or withdraw it by passing nullptr.
+        /// Only the entries of this well are modified in the scratch state.
+        void setScratchWellState(WellState* scratch_state) { scratch_well_state_ = scratch_state; }
+
         virtual void updateWellStateWithTarget(const Simulator& ebos_simulator,
                                                WellState& well_state,
                                                Opm::DeferredLogger& deferred_logger) const = 0;
@@ -243,7 +268,7 @@ namespace Opm
         // Add well contributions to matrix
         virtual void addWellContributions(SparseMatrixAdapter&) const = 0;
 
-        void addCellRates(RateVector& rates, int cellIdx) const;
+        void addPerforationRates(RateVector& rates, int perfIdx) const;
 
         Scalar volumetricSurfaceRateForConnection(int cellIdx, int phaseIdx) const;
 
@@ -285,6 +310,11 @@ namespace Opm
         // whether the well is operable
         bool isOperable() const;
 
+        // add the number of operability checks that reused the previous
+        // result, and the number that were computed, to the report, and
+        // start counting again.
+        void addOperabilityCacheStatistics(SimulatorReportSingle& report);
+
         /// Returns true if the well has one or more THP limits/constraints.
         bool wellHasTHPConstraints(const SummaryState& summaryState) const;
 
@@ -321,6 +351,14 @@ namespace Opm
 
         void setDynamicThpLimit(const double thp_limit);
 
+        // Derivatives of the surface production rates of a producer under THP
+        // control with respect to its THP, from the inflow performance
+        // relationship and the VFP table of the well linearized at the current
+        // rates. Zero for the other wells.
+        std::vector<double> productionRateDerivativesThp(const Simulator& ebosSimulator,
+                                                         const WellState& well_state,
+                                                         Opm::DeferredLogger& deferred_logger) const;
+
         void solveWellEquation(const Simulator& ebosSimulator,
                                WellState& well_state,
                                Opm::DeferredLogger& deferred_logger);
@@ -343,6 +381,9 @@ namespace Opm
         // number of the perforations for this well
         int number_of_perforations_;
 
+        // number of inner iterations of the last solve of the well equations
+        int last_inner_iterations_ = 0;
+
         // well index for each perforation
         std::vector<double> well_index_;
 
@@ -357,6 +398,9 @@ namespace Opm
         // cell index for each well perforation
         std::vector<int> well_cells_;
 
+        // pairs of cell index and perforation index, sorted by cell
+        std::vector<std::pair<int, int>> perforations_by_cell_;
+
         // saturation table nubmer for each well perforation
         std::vector<int> saturation_table_number_;
 
@@ -434,6 +478,12 @@ namespace Opm
         mutable std::vector<double> ipr_a_;
         mutable std::vector<double> ipr_b_;
 
+        // bhp(flo) curve of the VFP table at the last THP limit operating point
+        mutable detail::VFPProdCurveCache vfp_curve_cache_;
+
+        // scratch well state lent by the well model, see setScratchWellState()
+        WellState* scratch_well_state_ = nullptr;
+
         bool changed_to_stopped_this_step_ = false;
 
         const PhaseUsage& phaseUsage() const;
@@ -458,6 +508,27 @@ namespace Opm
 
         double getTHPConstraint(const SummaryState& summaryState) const;
 
+        // Bhp at the THP limit of a producer without iterative root finding.
+        // The inflow relation is approximated by the line through the flo
+        // rates at two bhp values and intersected with the bhp(flo) curve of
+        // the VFP table. The result is only returned if it satisfies
+        // fbhp(frates(bhp)) = bhp within the given tolerance.
+        template <class RatesFunc, class BhpFunc>
+        std::optional<double> bhpAtThpLimitProdFromVfpCurve(const RatesFunc& frates,
+                                                            const BhpFunc& fbhp,
+                                                            const int table_id,
+                                                            const double thp_limit,
+                                                            const double alq,
+                                                            const double dp,
+                                                            const double bhp_limit,
+                                                            const double tolerance) const;
+
+        // Well state to run a trial solution of this well on. With a scratch
+        // state lent, the entries of this well in it are reset from well_state,
+        // otherwise well_state is copied into own_copy.
+        WellState& trialWellState(const WellState& well_state,
+                                  std::optional<WellState>& own_copy) const;
+
         // Component fractions for each phase for the well
         const std::vector<double>& compFrac() const;
 
@@ -503,6 +574,24 @@ namespace Opm
 
         OperabilityStatus operability_status_;
 
+        // the state the operability of the well depends on. The result of
+        // the operability check is reused as long as the state does not
+        // change. If empty the check is always done.
+        virtual std::vector<double> operabilitySignature(const Simulator& /* ebos_simulator */,
+                                                         const WellState& /* well_state */) const
+        {
+            return {};
+        }
+
+        // result of the last operability check, with the state it was done for
+        std::vector<double> operability_signature_;
+        OperabilityStatus cached_operability_status_;
+        std::vector<double> cached_ipr_a_;
+        std::vector<double> cached_ipr_b_;
+        Opm::DeferredLogger cached_operability_messages_;
+        unsigned int operability_cache_hits_ = 0;
+        unsigned int operability_cache_misses_ = 0;
+
         // check whether the well is operable under BHP limit with current reservoir condition
         virtual void checkOperabilityUnderBHPLimitProducer(const WellState& well_state, const Simulator& ebos_simulator, Opm::DeferredLogger& deferred_logger) =0;
 
@@ -20,6 +20,7 @@
 */
 
 #include <opm/parser/eclipse/EclipseState/Schedule/ScheduleTypes.hpp>
+#include <opm/parser/eclipse/Units/Units.hpp>
 #include <opm/simulators/utils/DeferredLoggingErrorHelpers.hpp>
 #include <opm/simulators/wells/TargetCalculator.hpp>
 
@@ -79,8 +80,10 @@ namespace Opm
                 well_cells_[perf] = pd.cell_index;
                 well_index_[perf] = pd.connection_transmissibility_factor;
                 saturation_table_number_[perf] = pd.satnum_id;
+                perforations_by_cell_.emplace_back(pd.cell_index, perf);
                 ++perf;
             }
+            std::sort(perforations_by_cell_.begin(), perforations_by_cell_.end());
         }
 
         // initialization of the completions mapping
@@ -367,6 +370,63 @@ namespace Opm
 
 
 
+    template<typename TypeTag>
+    std::vector<double>
+    WellInterface<TypeTag>::
+    productionRateDerivativesThp(const Simulator& ebosSimulator,
+                                 const WellState& well_state,
+                                 Opm::DeferredLogger& deferred_logger) const
+    {
+        const int np = number_of_phases_;
+        std::vector<double> derivatives(np, 0.0);
+        if (!this->isProducer()
+            || well_state.currentProductionControls()[index_of_well_] != Well::ProducerCMode::THP) {
+            return derivatives;
+        }
+
+        updateIPR(ebosSimulator, deferred_logger);
+
+        const auto& summary_state = ebosSimulator.vanguard().summaryState();
+        const auto& controls = well_ecl_.productionControls(summary_state);
+        const auto& pu = phaseUsage();
+        const double* rates = &well_state.wellRates()[index_of_well_ * np];
+        std::array<double, 3> phase_rates = {0.0, 0.0, 0.0};
+        for (const int phase : {Water, Oil, Gas}) {
+            if (pu.phase_used[phase]) {
+                phase_rates[phase] = rates[pu.phase_pos[phase]];
+            }
+        }
+        std::array<double, 3> dbhp_drates;
+        double dbhp_dthp = 0.0;
+        vfp_properties_->getProd()->bhp(controls.vfp_table_number,
+                                        phase_rates[Water], phase_rates[Oil], phase_rates[Gas],
+                                        well_state.thp()[index_of_well_],
+                                        well_state.getALQ(name()),
+                                        dbhp_drates, dbhp_dthp);
+
+        // With the inflow rates b_p * bhp - a_p (negative for production) and
+        // bhp = vfp(rates, thp) - dp, a change of the thp changes the bhp by
+        // dvfp/dthp / (1 - sum_p dvfp/drate_p * b_p).
+        double denominator = 1.0;
+        for (const int phase : {Water, Oil, Gas}) {
+            if (pu.phase_used[phase]) {
+                denominator -= dbhp_drates[phase] * ipr_b_[pu.phase_pos[phase]];
+            }
+        }
+        if (denominator <= 0.0) {
+            // The inflow and the VFP curve do not intersect stably.
+            return derivatives;
+        }
+        const double dbhp = dbhp_dthp / denominator;
+        for (int p = 0; p < np; ++p) {
+            derivatives[p] = -ipr_b_[p] * dbhp;
+        }
+        return derivatives;
+    }
+
+
+
+
 
     template<typename TypeTag>
     double
@@ -506,6 +566,110 @@ namespace Opm
 
 
 
+    template<typename TypeTag>
+    typename WellInterface<TypeTag>::WellState&
+    WellInterface<TypeTag>::
+    trialWellState(const WellState& well_state,
+                   std::optional<WellState>& own_copy) const
+    {
+        if (scratch_well_state_ != nullptr) {
+            scratch_well_state_->copyWellEntries(well_state, index_of_well_);
+            return *scratch_well_state_;
+        }
+        own_copy = well_state;
+        return *own_copy;
+    }
+
+
+
+
+    template<typename TypeTag>
+    template <class RatesFunc, class BhpFunc>
+    std::optional<double>
+    WellInterface<TypeTag>::
+    bhpAtThpLimitProdFromVfpCurve(const RatesFunc& frates,
+                                  const BhpFunc& fbhp,
+                                  const int table_id,
+                                  const double thp_limit,
+                                  const double alq,
+                                  const double dp,
+                                  const double bhp_limit,
+                                  const double tolerance) const
+    {
+        const auto& table = vfp_properties_->getProd()->getTable(table_id);
+        const auto flo_type = table.getFloType();
+        // the production rates are negative, but the VFP flo values positive
+        auto flo = [flo_type](const std::vector<double>& rates) {
+            return -detail::getFlo(rates[Water], rates[Oil], rates[Gas], flo_type);
+        };
+
+        // The inflow relation is linear in bhp as long as no connection
+        // crossflows, hence two points give the inflow line.
+        const double bhp_delta = 10.0 * unit::barsa;
+        const std::vector<double> rates_limit = frates(bhp_limit);
+        const double flo_limit = flo(rates_limit);
+        const double flo_delta = flo(frates(bhp_limit + bhp_delta));
+        if (!(flo_limit > 0.0) || flo_limit == flo_delta) {
+            return std::nullopt;
+        }
+        const double slope = bhp_delta / (flo_delta - flo_limit);
+        auto inflow_bhp = [bhp_limit, flo_limit, slope](const double flo_value) {
+            return bhp_limit + slope * (flo_value - flo_limit);
+        };
+
+        // The VFP curve at the THP limit with the fractions at the bhp limit.
+        const double wfr = detail::getWFR(rates_limit[Water], rates_limit[Oil], rates_limit[Gas], table.getWFRType());
+        const double gfr = detail::getGFR(rates_limit[Water], rates_limit[Oil], rates_limit[Gas], table.getGFRType());
+        const auto& flo_axis = table.getFloAxis();
+        const auto& curve = vfp_curve_cache_.curve(table, thp_limit, wfr, gfr, alq);
+        int flo_hint = -1;
+        auto vfp_bhp = [&flo_axis, &curve, &flo_hint, dp](const double flo_value) {
+            const auto flo_i = detail::findInterpData(flo_value, flo_axis, flo_hint);
+            return (1.0 - flo_i.factor_) * curve[flo_i.ind_[0]] + flo_i.factor_ * curve[flo_i.ind_[1]] - dp;
+        };
+
+        // Both curves are linear between the flo axis samples in the range
+        // from zero rate to the rate at the bhp limit. Take the last sign
+        // change of their difference, i.e. the solution with the highest rate.
+        std::vector<double> flo_samples{0.0};
+        for (const double flo_value : flo_axis) {
+            if (flo_value > 0.0 && flo_value < flo_limit) {
+                flo_samples.push_back(flo_value);
+            }
+        }
+        flo_samples.push_back(flo_limit);
+
+        int segment = -1;
+        double diff_low = 0.0;
+        double diff_high = 0.0;
+        double diff_prev = vfp_bhp(flo_samples[0]) - inflow_bhp(flo_samples[0]);
+        for (std::size_t i = 1; i < flo_samples.size(); ++i) {
+            const double diff = vfp_bhp(flo_samples[i]) - inflow_bhp(flo_samples[i]);
+            if (diff_prev * diff <= 0.0 && diff_prev != diff) {
+                segment = i - 1;
+                diff_low = diff_prev;
+                diff_high = diff;
+            }
+            diff_prev = diff;
+        }
+        if (segment < 0) {
+            return std::nullopt;
+        }
+
+        const double flo_low = flo_samples[segment];
+        const double flo_high = flo_samples[segment + 1];
+        const double flo_solution = flo_low + (flo_high - flo_low) * diff_low / (diff_low - diff_high);
+        const double bhp = inflow_bhp(flo_solution);
+
+        if (std::abs(fbhp(frates(bhp)) - bhp) > tolerance) {
+            return std::nullopt;
+        }
+        return bhp;
+    }
+
+
+
+
 
 
     template<typename TypeTag>
@@ -1401,25 +1565,23 @@ namespace Opm
 
     template<typename TypeTag>
     void
-    WellInterface<TypeTag>::addCellRates(RateVector& rates, int cellIdx) const
+    WellInterface<TypeTag>::addPerforationRates(RateVector& rates, int perfIdx) const
     {
-        for (int perfIdx = 0; perfIdx < number_of_perforations_; ++perfIdx) {
-            if (cells()[perfIdx] == cellIdx) {
-                for (int i = 0; i < RateVector::dimension; ++i) {
-                    rates[i] += connectionRates_[perfIdx][i];
-                }
-            }
+        for (int i = 0; i < RateVector::dimension; ++i) {
+            rates[i] += connectionRates_[perfIdx][i];
         }
     }
 
     template<typename TypeTag>
     typename WellInterface<TypeTag>::Scalar
     WellInterface<TypeTag>::volumetricSurfaceRateForConnection(int cellIdx, int phaseIdx) const {
-        for (int perfIdx = 0; perfIdx < number_of_perforations_; ++perfIdx) {
-            if (cells()[perfIdx] == cellIdx) {
-                const unsigned activeCompIdx = Indices::canonicalToActiveComponentIndex(FluidSystem::solventComponentIndex(phaseIdx));
-                return connectionRates_[perfIdx][activeCompIdx].value();
-            }
+        // the first perforation of the cell
+        const auto perf = std::lower_bound(perforations_by_cell_.begin(), perforations_by_cell_.end(),
+                                           std::make_pair(cellIdx, 0));
+        if (perf != perforations_by_cell_.end() && perf->first == cellIdx) {
+            const int perfIdx = perf->second;
+            const unsigned activeCompIdx = Indices::canonicalToActiveComponentIndex(FluidSystem::solventComponentIndex(phaseIdx));
+            return connectionRates_[perfIdx][activeCompIdx].value();
         }
         // this is not thread safe
         OPM_THROW(std::invalid_argument, "The well with name " + name()
@@ -1480,7 +1642,8 @@ namespace Opm
             welltest_state.openWell(name(), WellTestConfig::PHYSICAL );
             const std::string msg = " well " + name() + " is re-opened through well testing for physical reason";
             deferred_logger.info(msg);
-            well_state = well_state_copy;
+            // only the entries of this well differ from the original state
+            well_state.copyWellEntries(well_state_copy, index_of_well_);
         } else {
             const std::string msg = " well " + name() + " is not operable during well testing for physical reason";
             deferred_logger.debug(msg);
@@ -1554,13 +1717,48 @@ namespace Opm
         const Well::ProducerCMode& current_control = well_state.currentProductionControls()[this->index_of_well_];
         // Operability checking is not free
         // Only check wells under BHP and THP control
-        if(current_control == Well::ProducerCMode::BHP || current_control == Well::ProducerCMode::THP) {
-            updateIPR(ebos_simulator, deferred_logger);
-            checkOperabilityUnderBHPLimitProducer(well_state, ebos_simulator, deferred_logger);
+        if (current_control != Well::ProducerCMode::BHP && current_control != Well::ProducerCMode::THP) {
+            return;
         }
+
+        // The check is repeated several times in a time step, mostly for an
+        // unchanged state of the well.
+        auto signature = operabilitySignature(ebos_simulator, well_state);
+        if (!signature.empty()) {
+            bool reuse = signature == operability_signature_;
+            const auto& comm = this->parallel_well_info_.communication();
+            if (comm.size() > 1) {
+                // the ipr is computed by all processes of the well together
+                reuse = comm.min(reuse ? 1 : 0) == 1;
+            }
+            if (reuse) {
+                this->operability_status_ = cached_operability_status_;
+                ipr_a_ = cached_ipr_a_;
+                ipr_b_ = cached_ipr_b_;
+                // repeat the messages of the check, as if it was done again
+                deferred_logger.append(cached_operability_messages_);
+                ++operability_cache_hits_;
+                return;
+            }
+            ++operability_cache_misses_;
+        }
+
+        // The messages of the check are kept with its result.
+        Opm::DeferredLogger check_logger;
+        updateIPR(ebos_simulator, check_logger);
+        checkOperabilityUnderBHPLimitProducer(well_state, ebos_simulator, check_logger);
         // we do some extra checking for wells under THP control.
         if (current_control == Well::ProducerCMode::THP) {
-            checkOperabilityUnderTHPLimitProducer(ebos_simulator, well_state, deferred_logger);
+            checkOperabilityUnderTHPLimitProducer(ebos_simulator, well_state, check_logger);
+        }
+        deferred_logger.append(check_logger);
+
+        if (!signature.empty()) {
+            operability_signature_ = std::move(signature);
+            cached_operability_status_ = this->operability_status_;
+            cached_ipr_a_ = ipr_a_;
+            cached_ipr_b_ = ipr_b_;
+            cached_operability_messages_ = std::move(check_logger);
         }
     }
 
@@ -1576,6 +1774,20 @@ namespace Opm
 
 
 
+    template<typename TypeTag>
+    void
+    WellInterface<TypeTag>::
+    addOperabilityCacheStatistics(SimulatorReportSingle& report)
+    {
+        report.well_operability_cache_hits += operability_cache_hits_;
+        report.well_operability_cache_misses += operability_cache_misses_;
+        operability_cache_hits_ = 0;
+        operability_cache_misses_ = 0;
+    }
+
+
+
+
 
     template <typename TypeTag>
     bool
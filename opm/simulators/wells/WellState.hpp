@@ -57,8 +57,8 @@ namespace Opm
                   const std::vector<std::vector<PerforationData>>& well_perf_data,
                   const SummaryState& summary_state)
         {
-            // clear old name mapping
-            wellMap_.clear();
+            // new name mapping, the old one may still be shared with copies
+            auto well_map = std::make_shared<WellMapType>();
 
             well_perf_data_ = well_perf_data;
             parallel_well_info_ = parallel_well_info;
@@ -85,12 +85,13 @@ namespace Opm
                     const int num_perf_this_well = well_perf_data[w].size();
                     std::string name = well.name();
                     assert( name.size() > 0 );
-                    mapentry_t& wellMapEntry = wellMap_[name];
+                    mapentry_t& wellMapEntry = (*well_map)[name];
                     wellMapEntry[ 0 ] = w;
                     wellMapEntry[ 1 ] = connpos;
                     wellMapEntry[ 2 ] = num_perf_this_well;
                     connpos += num_perf_this_well;
                 }
+                wellMap_ = std::move(well_map);
 
                 // The perforation rates and perforation pressures are
                 // not expected to be consistent with bhp_ and wellrates_
@@ -192,8 +193,7 @@ namespace Opm
             return getRestartTemperatureOffset() + temperature_.size();
         }
 
-        const WellMapType& wellMap() const { return wellMap_; }
-        WellMapType& wellMap() { return wellMap_; }
+        const WellMapType& wellMap() const { return *wellMap_; }
 
         const ParallelWellInfo& parallelWellInfo(std::size_t well_index) const
         {
@@ -242,7 +242,7 @@ namespace Opm
             using rt = data::Rates::opt;
 
             data::Wells dw;
-            for( const auto& itr : this->wellMap_ ) {
+            for( const auto& itr : *this->wellMap_ ) {
                 const auto well_index = itr.second[ 0 ];
                 if (this->status_[well_index] == Well::Status::SHUT)
                     continue;
@@ -324,7 +324,9 @@ namespace Opm
         std::vector<Well::Status> status_;
     private:
 
-        WellMapType wellMap_;
+        // The map does not change after init(), so it is shared between
+        // copies of the state to keep copying cheap.
+        std::shared_ptr<const WellMapType> wellMap_ = std::make_shared<const WellMapType>();
 
         using MPIComm = typename Dune::MPIHelper::MPICommunicator;
 #if DUNE_VERSION_NEWER(DUNE_COMMON, 2, 7)
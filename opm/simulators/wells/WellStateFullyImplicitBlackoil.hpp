@@ -21,6 +21,7 @@
 #ifndef OPM_WELLSTATEFULLYIMPLICITBLACKOIL_HEADER_INCLUDED
 #define OPM_WELLSTATEFULLYIMPLICITBLACKOIL_HEADER_INCLUDED
 
+#include <opm/simulators/wells/NameIndex.hpp>
 #include <opm/simulators/wells/WellState.hpp>
 #include <opm/core/props/BlackoilPhases.hpp>
 
@@ -35,6 +36,7 @@
 #include <iostream>
 #include <map>
 #include <numeric>
+#include <optional>
 #include <string>
 #include <utility>
 #include <vector>
@@ -83,13 +85,26 @@ namespace Opm
             // call init on base class
             BaseType :: init(cellPressures, wells_ecl, parallel_well_info, pu, well_perf_data, summary_state);
 
+            // resolve the names of the wells and groups of this report step
+            // once, the group control data is stored by their indices.
+            for (const auto& wname : schedule.wellNames(report_step)) {
+                well_names_.insert(wname);
+            }
+            for (const auto& gname : schedule.groupNames(report_step)) {
+                group_names_.insert(gname);
+            }
+
             for (const auto& winfo: parallel_well_info)
             {
-                well_rates.insert({winfo->name(), std::make_pair(winfo->isOwner(), std::vector<double>())});
+                const int w = well_names_.insert(winfo->name());
+                resizeToNames(well_rates_, well_names_);
+                if (!well_rates_[w]) {
+                    well_rates_[w].emplace(winfo->isOwner(), std::vector<double>());
+                }
             }
             globalIsInjectionGrup_.assign(globalNumberOfWells,0);
             globalIsProductionGrup_.assign(globalNumberOfWells,0);
-            wellNameToGlobalIdx_.clear();
+            global_well_index_.clear();
 
             const int nw = wells_ecl.size();
 
@@ -368,170 +383,240 @@ namespace Opm
         std::vector<Well::ProducerCMode>& currentProductionControls() { return current_production_controls_; }
         const std::vector<Well::ProducerCMode>& currentProductionControls() const { return current_production_controls_; }
 
+        /// Index of the group \p groupName in the group data, or -1 if the
+        /// group is unknown.  The indices of the groups never change, so
+        /// they may be resolved once and used with the overloads taking
+        /// a group index, also for copies of this state.
+        int groupIndex(const std::string& groupName) const {
+            return group_names_.index(groupName);
+        }
+
+        /// Index of the well \p wellName in the data stored by well name,
+        /// or -1 if the well is unknown.  Stable like groupIndex().
+        int wellNameIndex(const std::string& wellName) const {
+            return well_names_.index(wellName);
+        }
+
         bool hasProductionGroupControl(const std::string& groupName) const {
-            return current_production_group_controls_.count(groupName) > 0;
+            return findGroupValue(current_production_group_controls_, groupName) != nullptr;
         }
 
         bool hasInjectionGroupControl(const Opm::Phase& phase, const std::string& groupName) const {
-            return current_injection_group_controls_.count(std::make_pair(phase, groupName)) > 0;
+            return findGroupValue(current_injection_group_controls_[injectionPhaseIndex(phase)], groupName) != nullptr;
         }
 
         /// One current control per group.
         void setCurrentProductionGroupControl(const std::string& groupName, const Group::ProductionCMode& groupControl ) {
-            current_production_group_controls_[groupName] = groupControl;
+            setGroupValue(current_production_group_controls_, groupName, groupControl);
         }
 
         const Group::ProductionCMode& currentProductionGroupControl(const std::string& groupName) const {
-            auto it = current_production_group_controls_.find(groupName);
+            const auto* control = findGroupValue(current_production_group_controls_, groupName);
 
-            if (it == current_production_group_controls_.end())
+            if (control == nullptr)
                 OPM_THROW(std::logic_error, "Could not find any control for production group " << groupName);
 
-            return it->second;
+            return *control;
+        }
+
+        const Group::ProductionCMode& currentProductionGroupControl(const int group) const {
+            const auto* control = findGroupValue(current_production_group_controls_, group);
+
+            if (control == nullptr)
+                OPM_THROW(std::logic_error, "Could not find any control for production group " << group_names_.name(group));
+
+            return *control;
         }
 
         /// One current control per group.
         void setCurrentInjectionGroupControl(const Opm::Phase& phase, const std::string& groupName, const Group::InjectionCMode& groupControl ) {
-            current_injection_group_controls_[std::make_pair(phase, groupName)] = groupControl;
+            setGroupValue(current_injection_group_controls_[injectionPhaseIndex(phase)], groupName, groupControl);
         }
 
         const Group::InjectionCMode& currentInjectionGroupControl(const Opm::Phase& phase, const std::string& groupName) const {
-            auto it = current_injection_group_controls_.find(std::make_pair(phase, groupName));
+            const auto* control = findGroupValue(current_injection_group_controls_[injectionPhaseIndex(phase)], groupName);
 
-            if (it == current_injection_group_controls_.end())
+            if (control == nullptr)
                 OPM_THROW(std::logic_error, "Could not find any control for " << phase << " injection group " << groupName);
 
-            return it->second;
+            return *control;
+        }
+
+        const Group::InjectionCMode& currentInjectionGroupControl(const Opm::Phase& phase, const int group) const {
+            const auto* control = findGroupValue(current_injection_group_controls_[injectionPhaseIndex(phase)], group);
+
+            if (control == nullptr)
+                OPM_THROW(std::logic_error, "Could not find any control for " << phase << " injection group " << group_names_.name(group));
+
+            return *control;
         }
 
         void setCurrentWellRates(const std::string& wellName, const std::vector<double>& rates ) {
-            well_rates[wellName].second = rates;
+            setCurrentWellRates(well_names_.insert(wellName), rates);
+        }
+
+        /// Set the rates of the well with index \p w, see wellNameIndex().
+        void setCurrentWellRates(const int w, const std::vector<double>& rates ) {
+            assert(w >= 0 && w < well_names_.size());
+            resizeToNames(well_rates_, well_names_);
+            if (!well_rates_[w]) {
+                // a well that was not present at init() is not owned
+                well_rates_[w].emplace(false, std::vector<double>());
+            }
+            well_rates_[w]->second = rates;
         }
 
         const std::vector<double>& currentWellRates(const std::string& wellName) const {
-            auto it = well_rates.find(wellName);
+            const auto* rates = findValue(well_rates_, well_names_, wellName);
 
-            if (it == well_rates.end())
+            if (rates == nullptr)
                 OPM_THROW(std::logic_error, "Could not find any rates for well  " << wellName);
 
-            return it->second.second;
+            return rates->second;
         }
 
         bool hasWellRates(const std::string& wellName) const {
-            return this->well_rates.find(wellName) != this->well_rates.end();
+            return findValue(well_rates_, well_names_, wellName) != nullptr;
         }
 
         void setCurrentProductionGroupRates(const std::string& groupName, const std::vector<double>& rates ) {
-            production_group_rates[groupName] = rates;
+            setGroupValue(production_group_rates_, groupName, rates);
+        }
+
+        void setCurrentProductionGroupRates(const int group, const std::vector<double>& rates ) {
+            setGroupValue(production_group_rates_, group, rates);
         }
 
         const std::vector<double>& currentProductionGroupRates(const std::string& groupName) const {
-            auto it = production_group_rates.find(groupName);
+            const auto* rates = findGroupValue(production_group_rates_, groupName);
 
-            if (it == production_group_rates.end())
+            if (rates == nullptr)
                 OPM_THROW(std::logic_error, "Could not find any rates for productino group  " << groupName);
 
-            return it->second;
+            return *rates;
         }
 
         bool hasProductionGroupRates(const std::string& groupName) const {
-            return this->production_group_rates.find(groupName) != this->production_group_rates.end();
+            return findGroupValue(production_group_rates_, groupName) != nullptr;
         }
 
         void setCurrentProductionGroupReductionRates(const std::string& groupName, const std::vector<double>& target ) {
-            production_group_reduction_rates[groupName] = target;
+            setGroupValue(production_group_reduction_rates_, groupName, target);
+        }
+
+        void setCurrentProductionGroupReductionRates(const int group, const std::vector<double>& target ) {
+            setGroupValue(production_group_reduction_rates_, group, target);
         }
 
         const std::vector<double>& currentProductionGroupReductionRates(const std::string& groupName) const {
-            auto it = production_group_reduction_rates.find(groupName);
+            const auto* rates = findGroupValue(production_group_reduction_rates_, groupName);
 
-            if (it == production_group_reduction_rates.end())
+            if (rates == nullptr)
                 OPM_THROW(std::logic_error, "Could not find any reduction rates for production group  " << groupName);
 
-            return it->second;
+            return *rates;
         }
 
         void setCurrentInjectionGroupReductionRates(const std::string& groupName, const std::vector<double>& target ) {
-            injection_group_reduction_rates[groupName] = target;
+            setGroupValue(injection_group_reduction_rates_, groupName, target);
+        }
+
+        void setCurrentInjectionGroupReductionRates(const int group, const std::vector<double>& target ) {
+            setGroupValue(injection_group_reduction_rates_, group, target);
         }
 
         const std::vector<double>& currentInjectionGroupReductionRates(const std::string& groupName) const {
-            auto it = injection_group_reduction_rates.find(groupName);
+            const auto* rates = findGroupValue(injection_group_reduction_rates_, groupName);
 
-            if (it == injection_group_reduction_rates.end())
+            if (rates == nullptr)
                 OPM_THROW(std::logic_error, "Could not find any reduction rates for injection group " << groupName);
 
-            return it->second;
+            return *rates;
         }
 
         void setCurrentInjectionGroupReservoirRates(const std::string& groupName, const std::vector<double>& target ) {
-            injection_group_reservoir_rates[groupName] = target;
+            setGroupValue(injection_group_reservoir_rates_, groupName, target);
+        }
+
+        void setCurrentInjectionGroupReservoirRates(const int group, const std::vector<double>& target ) {
+            setGroupValue(injection_group_reservoir_rates_, group, target);
         }
 
         const std::vector<double>& currentInjectionGroupReservoirRates(const std::string& groupName) const {
-            auto it = injection_group_reservoir_rates.find(groupName);
+            const auto* rates = findGroupValue(injection_group_reservoir_rates_, groupName);
 
-            if (it == injection_group_reservoir_rates.end())
+            if (rates == nullptr)
                 OPM_THROW(std::logic_error, "Could not find any reservoir rates for injection group " << groupName);
 
-            return it->second;
+            return *rates;
         }
 
         void setCurrentInjectionVREPRates(const std::string& groupName, const double& target ) {
-            injection_group_vrep_rates[groupName] = target;
+            setGroupValue(injection_group_vrep_rates_, groupName, target);
+        }
+
+        void setCurrentInjectionVREPRates(const int group, const double& target ) {
+            setGroupValue(injection_group_vrep_rates_, group, target);
         }
 
         const double& currentInjectionVREPRates(const std::string& groupName) const {
-            auto it = injection_group_vrep_rates.find(groupName);
+            const auto* rate = findGroupValue(injection_group_vrep_rates_, groupName);
 
-            if (it == injection_group_vrep_rates.end())
+            if (rate == nullptr)
                 OPM_THROW(std::logic_error, "Could not find any VREP rates for group " << groupName);
 
-            return it->second;
+            return *rate;
         }
 
         void setCurrentInjectionREINRates(const std::string& groupName, const std::vector<double>& target ) {
-            injection_group_rein_rates[groupName] = target;
+            setGroupValue(injection_group_rein_rates_, groupName, target);
+        }
+
+        void setCurrentInjectionREINRates(const int group, const std::vector<double>& target ) {
+            setGroupValue(injection_group_rein_rates_, group, target);
         }
 
         const std::vector<double>& currentInjectionREINRates(const std::string& groupName) const {
-            auto it = injection_group_rein_rates.find(groupName);
+            const auto* rates = findGroupValue(injection_group_rein_rates_, groupName);
 
-            if (it == injection_group_rein_rates.end())
+            if (rates == nullptr)
                 OPM_THROW(std::logic_error, "Could not find any REIN rates for group " << groupName);
 
-            return it->second;
+            return *rates;
         }
 
         void setCurrentGroupGratTargetFromSales(const std::string& groupName, const double& target ) {
-            group_grat_target_from_sales[groupName] = target;
+            setGroupValue(group_grat_target_from_sales_, groupName, target);
         }
 
         bool hasGroupGratTargetFromSales(const std::string& groupName) const {
-            auto it = group_grat_target_from_sales.find(groupName);
-            return it != group_grat_target_from_sales.end();
+            return findGroupValue(group_grat_target_from_sales_, groupName) != nullptr;
         }
 
         const double& currentGroupGratTargetFromSales(const std::string& groupName) const {
-            auto it = group_grat_target_from_sales.find(groupName);
+            const auto* target = findGroupValue(group_grat_target_from_sales_, groupName);
 
-            if (it == group_grat_target_from_sales.end())
+            if (target == nullptr)
                 OPM_THROW(std::logic_error, "Could not find any grat target from sales for group " << groupName);
 
-            return it->second;
+            return *target;
         }
 
         void setCurrentGroupInjectionPotentials(const std::string& groupName, const std::vector<double>& pot ) {
-            injection_group_potentials[groupName] = pot;
+            setGroupValue(injection_group_potentials_, groupName, pot);
+        }
+
+        void setCurrentGroupInjectionPotentials(const int group, const std::vector<double>& pot ) {
+            setGroupValue(injection_group_potentials_, group, pot);
         }
 
         const std::vector<double>& currentGroupInjectionPotentials(const std::string& groupName) const {
-            auto it = injection_group_potentials.find(groupName);
+            const auto* pot = findGroupValue(injection_group_potentials_, groupName);
 
-            if (it == injection_group_potentials.end())
+            if (pot == nullptr)
                 OPM_THROW(std::logic_error, "Could not find any potentials for group " << groupName);
 
-            return it->second;
+            return *pot;
         }
 
 
@@ -1098,45 +1183,104 @@ namespace Opm
             WellState::stopWell(well_index);
         }
 
+        /// Copy the per-well, per-connection and per-segment entries of well
+        /// \p well_index from \p src, leaving the entries of all other wells
+        /// untouched.  Both states must have the same layout, i.e. \p src
+        /// must be a copy of this state, or this state a copy of \p src.
+        void copyWellEntries(const WellStateFullyImplicitBlackoil& src, const int well_index)
+        {
+            const int np = numPhases();
+            const int first_perf = first_perf_index_[well_index];
+            const int end_perf = first_perf_index_[well_index + 1];
+            const int top_seg = topSegmentIndex(well_index);
+            const int end_seg = top_seg + numSegments(well_index);
+
+            auto copyRange = [](const auto& from, auto& to, const int begin, const int end) {
+                std::copy(from.begin() + begin, from.begin() + end, to.begin() + begin);
+            };
+
+            // entries held by the base class
+            this->bhp()[well_index] = src.bhp()[well_index];
+            this->thp()[well_index] = src.thp()[well_index];
+            this->temperature()[well_index] = src.temperature()[well_index];
+            this->status_[well_index] = src.status_[well_index];
+            copyRange(src.wellRates(), this->wellRates(), np * well_index, np * (well_index + 1));
+            copyRange(src.perfRates(), this->perfRates(), first_perf, end_perf);
+            copyRange(src.perfPress(), this->perfPress(), first_perf, end_perf);
+
+            // per well
+            current_injection_controls_[well_index] = src.current_injection_controls_[well_index];
+            current_production_controls_[well_index] = src.current_production_controls_[well_index];
+            effective_events_occurred_[well_index] = src.effective_events_occurred_[well_index];
+            well_dissolved_gas_rates_[well_index] = src.well_dissolved_gas_rates_[well_index];
+            well_vaporized_oil_rates_[well_index] = src.well_vaporized_oil_rates_[well_index];
+            copyRange(src.well_reservoir_rates_, well_reservoir_rates_, np * well_index, np * (well_index + 1));
+            copyRange(src.productivity_index_, productivity_index_, np * well_index, np * (well_index + 1));
+            copyRange(src.well_potentials_, well_potentials_, np * well_index, np * (well_index + 1));
+
+            // per connection
+            copyRange(src.perfphaserates_, perfphaserates_, np * first_perf, np * end_perf);
+            copyRange(src.conn_productivity_index_, conn_productivity_index_, np * first_perf, np * end_perf);
+            copyRange(src.perfRateSolvent_, perfRateSolvent_, first_perf, end_perf);
+            copyRange(src.perfRatePolymer_, perfRatePolymer_, first_perf, end_perf);
+            copyRange(src.perfRateBrine_, perfRateBrine_, first_perf, end_perf);
+            copyRange(src.perf_water_throughput_, perf_water_throughput_, first_perf, end_perf);
+            copyRange(src.perf_skin_pressure_, perf_skin_pressure_, first_perf, end_perf);
+            copyRange(src.perf_water_velocity_, perf_water_velocity_, first_perf, end_perf);
+
+            // per segment
+            copyRange(src.seg_rates_, seg_rates_, np * top_seg, np * end_seg);
+            copyRange(src.seg_press_, seg_press_, top_seg, end_seg);
+            copyRange(src.seg_pressdrop_, seg_pressdrop_, top_seg, end_seg);
+            copyRange(src.seg_pressdrop_friction_, seg_pressdrop_friction_, top_seg, end_seg);
+            copyRange(src.seg_pressdrop_hydorstatic_, seg_pressdrop_hydorstatic_, top_seg, end_seg);
+            copyRange(src.seg_pressdrop_acceleration_, seg_pressdrop_acceleration_, top_seg, end_seg);
+        }
+
         template<class Comm>
         void communicateGroupRates(const Comm& comm)
         {
-            // Note that injection_group_vrep_rates is handled separate from
-            // the forAllGroupData() function, since it contains single doubles,
+            // Note that the VREP rates and the ALQ values are handled separate
+            // from the forAllGroupData() function, since they are single doubles,
             // not vectors.
+            //
+            // The entries are visited in the order of the group and well
+            // names, which is the same on all processes.
 
             // Create a function that calls some function
             // for all the individual data items to simplify
             // the further code.
-            auto iterateContainer = [](auto& container, auto& func) {
-                for (auto& x : container) {
-                    func(x.second);
-                }
+            auto iterateContainer = [this](auto& container, auto& func) {
+                forEachValue(container, group_names_, func);
             };
-            auto iterateRatesContainer = [](auto& container, auto& func) {
-                for (auto& x : container) {
-                    if (x.second.first)
+            auto iterateRatesContainer = [this](auto& container, auto& func) {
+                forEachValue(container, well_names_, [&func](auto& x) {
+                    if (x.first)
                     {
-                        func(x.second.second);
+                        func(x.second);
                     }
                     else
                     {
                         // We might actually store non-zero values for
                         // distributed wells even if they are not owned.
                         std::vector<double> dummyRate;
-                        dummyRate.assign(x.second.second.size(), 0);
+                        dummyRate.assign(x.second.size(), 0);
                         func(dummyRate);
                     }
-                }
+                });
             };
 
             auto forAllGroupData = [&](auto& func) {
-                iterateContainer(injection_group_rein_rates, func);
-                iterateContainer(production_group_reduction_rates, func);
-                iterateContainer(injection_group_reduction_rates, func);
-                iterateContainer(injection_group_reservoir_rates, func);
-                iterateContainer(production_group_rates, func);
-                iterateRatesContainer(well_rates, func);
+                iterateContainer(injection_group_rein_rates_, func);
+                iterateContainer(production_group_reduction_rates_, func);
+                iterateContainer(injection_group_reduction_rates_, func);
+                iterateContainer(injection_group_reservoir_rates_, func);
+                iterateContainer(production_group_rates_, func);
+                iterateRatesContainer(well_rates_, func);
+            };
+            auto forAllScalarData = [&](auto& func) {
+                forEachValue(injection_group_vrep_rates_, group_names_, func);
+                forEachValue(current_alq_, well_names_, func);
             };
 
             // Compute the size of the data.
@@ -1145,8 +1289,10 @@ namespace Opm
                 sz += v.size();
             };
             forAllGroupData(computeSize);
-            sz += injection_group_vrep_rates.size();
-            sz += current_alq_.size();
+            auto countScalar = [&sz](const double&) {
+                ++sz;
+            };
+            forAllScalarData(countScalar);
 
             // Make a vector and collect all data into it.
             std::vector<double> data(sz);
@@ -1157,12 +1303,10 @@ namespace Opm
                 }
             };
             forAllGroupData(collect);
-            for (const auto& x : injection_group_vrep_rates) {
-                data[pos++] = x.second;
-            }
-            for (const auto& x : current_alq_) {
-                data[pos++] = x.second;
-            }
+            auto collectScalar = [&data, &pos](const double& x) {
+                data[pos++] = x;
+            };
+            forAllScalarData(collectScalar);
             assert(pos == sz);
 
             // Communicate it with a single sum() call.
@@ -1176,12 +1320,10 @@ namespace Opm
                 }
             };
             forAllGroupData(distribute);
-            for (auto& x : injection_group_vrep_rates) {
-                x.second = data[pos++];
-            }
-            for (auto& x : current_alq_) {
-                x.second = data[pos++];
-            }
+            auto distributeScalar = [&data, &pos](double& x) {
+                x = data[pos++];
+            };
+            forAllScalarData(distributeScalar);
             assert(pos == sz);
         }
 
@@ -1194,7 +1336,9 @@ namespace Opm
             const auto& end = wellMap().end();
             for (const auto& well : schedule.getWells(reportStepIdx)) {
                 // Build global name->index map.
-                wellNameToGlobalIdx_[well.name()] = global_well_index;
+                const int w = well_names_.insert(well.name());
+                resizeToNames(global_well_index_, well_names_);
+                global_well_index_[w] = global_well_index;
 
                 // For wells on this process...
                 const auto& it = wellMap().find( well.name());
@@ -1224,35 +1368,51 @@ namespace Opm
 
         bool isInjectionGrup(const std::string& name) const {
 
-            auto it = wellNameToGlobalIdx_.find(name);
+            const auto* global_index = findValue(global_well_index_, well_names_, name);
 
-            if (it == wellNameToGlobalIdx_.end())
+            if (global_index == nullptr)
                 OPM_THROW(std::logic_error, "Could not find global injection group for well " << name);
 
-            return globalIsInjectionGrup_[it->second] != 0;
+            return globalIsInjectionGrup_[*global_index] != 0;
         }
 
         bool isProductionGrup(const std::string& name) const {
 
-            auto it = wellNameToGlobalIdx_.find(name);
+            const auto* global_index = findValue(global_well_index_, well_names_, name);
 
-            if (it == wellNameToGlobalIdx_.end())
+            if (global_index == nullptr)
                 OPM_THROW(std::logic_error, "Could not find global production group for well " << name);
 
-            return globalIsProductionGrup_[it->second] != 0;
+            return globalIsProductionGrup_[*global_index] != 0;
+        }
+
+        /// isProductionGrup() for the well with index \p w, see
+        /// wellNameIndex().
+        bool isProductionGrup(const int w) const {
+
+            const auto* global_index = findValue(global_well_index_, w);
+
+            if (global_index == nullptr)
+                OPM_THROW(std::logic_error, "Could not find global production group for well " << well_names_.name(w));
+
+            return globalIsProductionGrup_[*global_index] != 0;
         }
 
         double getALQ( const std::string& name) const
         {
-            if (this->current_alq_.count(name) == 0) {
-                return this->default_alq_.at(name);
+            const auto* alq = findValue(current_alq_, well_names_, name);
+            if (alq == nullptr) {
+                alq = findValue(default_alq_, well_names_, name);
             }
-            return this->current_alq_.at(name);
+            if (alq == nullptr)
+                OPM_THROW(std::logic_error, "Could not find any ALQ for well " << name);
+
+            return *alq;
         }
 
         void setALQ( const std::string& name, double value)
         {
-            this->current_alq_[name] = value;
+            setValue(current_alq_, well_names_, name, value);
         }
 
         bool gliftOptimizationEnabled() const {
@@ -1281,22 +1441,36 @@ namespace Opm
         // size of global number of wells
         std::vector<int> globalIsInjectionGrup_;
         std::vector<int> globalIsProductionGrup_;
-        std::map<std::string, int> wellNameToGlobalIdx_;
-
-        std::map<std::string, Group::ProductionCMode> current_production_group_controls_;
-        std::map<std::pair<Opm::Phase, std::string>, Group::InjectionCMode> current_injection_group_controls_;
-
-        std::map<std::string, std::pair<bool, std::vector<double>>> well_rates;
-        std::map<std::string, std::vector<double>> production_group_rates;
-        std::map<std::string, std::vector<double>> production_group_reduction_rates;
-        std::map<std::string, std::vector<double>> injection_group_reduction_rates;
-        std::map<std::string, std::vector<double>> injection_group_reservoir_rates;
-        std::map<std::string, std::vector<double>> injection_group_potentials;
-        std::map<std::string, double> injection_group_vrep_rates;
-        std::map<std::string, std::vector<double>> injection_group_rein_rates;
-        std::map<std::string, double> group_grat_target_from_sales;
-        std::map<std::string, double> current_alq_;
-        std::map<std::string, double> default_alq_;
+
+        // The group control data below is addressed by well and group name.
+        // The names are resolved into dense indices by well_names_ and
+        // group_names_, and each item is stored in a vector over these
+        // indices, where an empty optional means that no value has been set.
+        template <class T>
+        using PerName = std::vector<std::optional<T>>;
+
+        NameIndex well_names_;
+        NameIndex group_names_;
+
+        // per well name
+        PerName<int> global_well_index_;
+        PerName<std::pair<bool, std::vector<double>>> well_rates_;
+        PerName<double> current_alq_;
+        PerName<double> default_alq_;
+
+        // per group name
+        PerName<Group::ProductionCMode> current_production_group_controls_;
+        // one per injection phase, see injectionPhaseIndex()
+        std::array<PerName<Group::InjectionCMode>, 3> current_injection_group_controls_;
+        PerName<std::vector<double>> production_group_rates_;
+        PerName<std::vector<double>> production_group_reduction_rates_;
+        PerName<std::vector<double>> injection_group_reduction_rates_;
+        PerName<std::vector<double>> injection_group_reservoir_rates_;
+        PerName<std::vector<double>> injection_group_potentials_;
+        PerName<double> injection_group_vrep_rates_;
+        PerName<std::vector<double>> injection_group_rein_rates_;
+        PerName<double> group_grat_target_from_sales_;
+
         bool do_glift_optimization_;
 
         std::vector<double> perfRateSolvent_;
@@ -1333,7 +1507,9 @@ namespace Opm
         // some events happens to the well, like this well is a new well
         // or new well control keywords happens
         // \Note: for now, only WCON* keywords, and well status change is considered
-        std::vector<bool> effective_events_occurred_;
+        // Stored as char rather than bool, so that copyWellEntries() may be
+        // called for different wells concurrently.
+        std::vector<char> effective_events_occurred_;
 
         // MS well related
         // for StandardWell, the number of segments will be one
@@ -1431,13 +1607,101 @@ namespace Opm
             return this->seg_number_[top_offset + seg_id];
         }
 
+        static int injectionPhaseIndex(const Opm::Phase phase)
+        {
+            switch (phase) {
+            case Opm::Phase::WATER: return 0;
+            case Opm::Phase::OIL: return 1;
+            case Opm::Phase::GAS: return 2;
+            default:
+                OPM_THROW(std::logic_error, "No injection group control for phase " << phase);
+            }
+        }
+
+        template <class T>
+        static void resizeToNames(PerName<T>& values, const NameIndex& names)
+        {
+            if (static_cast<int>(values.size()) < names.size()) {
+                values.resize(names.size());
+            }
+        }
+
+        template <class T>
+        static const T* findValue(const PerName<T>& values, const int i)
+        {
+            if (i < 0 || i >= static_cast<int>(values.size()) || !values[i]) {
+                return nullptr;
+            }
+            return &(*values[i]);
+        }
+
+        template <class T>
+        static const T* findValue(const PerName<T>& values, const NameIndex& names, const std::string& name)
+        {
+            return findValue(values, names.index(name));
+        }
+
+        // The storage is only resized when the index of the name is beyond
+        // its end. For a name that is already in the index and has a slot
+        // in the storage, neither the names nor the other values are
+        // touched, so the wells may set their own values concurrently.
+        template <class T>
+        static void setValue(PerName<T>& values, NameIndex& names, const std::string& name, const T& value)
+        {
+            const int i = names.insert(name);
+            if (i >= static_cast<int>(values.size())) {
+                resizeToNames(values, names);
+            }
+            values[i] = value;
+        }
+
+        template <class T>
+        const T* findGroupValue(const PerName<T>& values, const std::string& groupName) const
+        {
+            return findValue(values, group_names_, groupName);
+        }
+
+        template <class T>
+        void setGroupValue(PerName<T>& values, const std::string& groupName, const T& value)
+        {
+            setValue(values, group_names_, groupName, value);
+        }
+
+        template <class T>
+        const T* findGroupValue(const PerName<T>& values, const int group) const
+        {
+            assert(group >= 0 && group < group_names_.size());
+            return findValue(values, group);
+        }
+
+        template <class T>
+        void setGroupValue(PerName<T>& values, const int group, const T& value)
+        {
+            assert(group >= 0 && group < group_names_.size());
+            if (group >= static_cast<int>(values.size())) {
+                resizeToNames(values, group_names_);
+            }
+            values[group] = value;
+        }
+
+        // Call func for all values that are set, in the order of the names.
+        template <class Values, class Func>
+        static void forEachValue(Values& values, const NameIndex& names, Func&& func)
+        {
+            for (const int i : names.sortedIndices()) {
+                if (i < static_cast<int>(values.size()) && values[i]) {
+                    func(*values[i]);
+                }
+            }
+        }
+
         // If the ALQ has changed since the previous report step,
         // reset current_alq and update default_alq. ALQ is used for
         // constant lift gas injection and for gas lift optimization
         // (THP controlled wells).
         //
         // NOTE: If a well is no longer used (e.g. it is shut down)
-        // it is still kept in the maps "default_alq_" and "current_alq_". Since the
+        // it is still kept in "default_alq_" and "current_alq_". Since the
         // number of unused entries should be small (negligible memory
         // overhead) this is simpler than writing code to delete it.
         //
@@ -1450,16 +1714,17 @@ namespace Opm
                     const std::string &name = well.name();
                     // NOTE: This is the value set in item 12 of WCONPROD, or with WELTARG
                     auto alq = well.alq_value();
-                    if (this->default_alq_.count(name) != 0) {
-                        if (this->default_alq_[name] == alq) {
+                    const auto* default_alq = findValue(this->default_alq_, this->well_names_, name);
+                    if (default_alq != nullptr) {
+                        if (*default_alq == alq) {
                             // If the previous value was the same, we leave current_alq_
                             // as it is.
                             continue;
                         }
                     }
-                    this->default_alq_[name] = alq;
+                    setValue(this->default_alq_, this->well_names_, name, alq);
                     // Reset current ALQ if a new value was given in WCONPROD
-                    this->current_alq_[name] = alq;
+                    setValue(this->current_alq_, this->well_names_, name, alq);
                 }
             }
         }
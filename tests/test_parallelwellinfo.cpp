@@ -468,3 +468,51 @@ BOOST_AUTO_TEST_CASE(GlobalPerfFactoryParallel1)
     testGlobalPerfFactoryParallel(1);
     testGlobalPerfFactoryParallel(3);
 }
+
+BOOST_AUTO_TEST_CASE(GlobalPerfContainerBatchParallel)
+{
+    auto comm = Communication(Dune::MPIHelper::getCommunicator());
+
+    // Two wells with different numbers of components and distributions
+    // that are exchanged together.
+    const std::vector<int> num_components = {1, 3};
+    const std::vector<bool> local_consecutive = {false, true};
+    const std::vector<int> well_indices = {4, 1};
+    Opm::ParallelWellInfo wellInfo1{ {"Test1", true }, comm };
+    Opm::ParallelWellInfo wellInfo2{ {"Test2", true }, comm };
+    const std::vector<Opm::ParallelWellInfo*> wellInfos = {&wellInfo1, &wellInfo2};
+
+    auto globalEclIndex = createGlobalEclIndex(comm);
+    std::vector<std::vector<double>> globalCurrent(wellInfos.size());
+    std::vector<std::vector<double>> localCurrent(wellInfos.size());
+    for (std::size_t w = 0; w < wellInfos.size(); ++w)
+    {
+        globalCurrent[w].resize(globalEclIndex.size() * num_components[w]);
+        initRandomNumbers(std::begin(globalCurrent[w]), std::end(globalCurrent[w]),
+                          comm);
+        localCurrent[w] = populateCommAbove(*wellInfos[w], comm, globalEclIndex,
+                                            globalCurrent[w], num_components[w],
+                                            local_consecutive[w]);
+    }
+
+    Opm::GlobalPerfContainerBatch batch(comm);
+    std::vector<std::size_t> positions(wellInfos.size());
+    for (std::size_t w = 0; w < wellInfos.size(); ++w)
+    {
+        positions[w] = batch.add(well_indices[w], *wellInfos[w], localCurrent[w],
+                                 num_components[w]);
+    }
+    batch.exchange();
+
+    for (std::size_t w = 0; w < wellInfos.size(); ++w)
+    {
+        const auto& globalCreated = batch.global(positions[w]);
+        BOOST_CHECK_EQUAL_COLLECTIONS(std::begin(globalCurrent[w]), std::end(globalCurrent[w]),
+                                      std::begin(globalCreated), std::end(globalCreated));
+
+        const auto& factory = wellInfos[w]->getGlobalPerfContainerFactory();
+        auto globalFactory = factory.createGlobal(localCurrent[w], num_components[w]);
+        BOOST_CHECK_EQUAL_COLLECTIONS(std::begin(globalFactory), std::end(globalFactory),
+                                      std::begin(globalCreated), std::end(globalCreated));
+    }
+}
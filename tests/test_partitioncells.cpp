@@ -0,0 +1,98 @@
+/*
+  Copyright 2021 Equinor ASA.
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <config.h>
+
+#define BOOST_TEST_MODULE TestPartitionCells
+
+#include <boost/test/unit_test.hpp>
+
+#include <opm/simulators/flow/partitionCells.hpp>
+
+#include <vector>
+
+namespace {
+    // Five-point stencil of an nx-by-ny Cartesian grid.
+    std::vector<std::vector<int>> cartesianNeighbours(const int nx, const int ny)
+    {
+        std::vector<std::vector<int>> neighbours(nx*ny);
+        for (int j = 0; j < ny; ++j) {
+            for (int i = 0; i < nx; ++i) {
+                const int cell = j*nx + i;
+                neighbours[cell].push_back(cell);
+                if (i > 0)      neighbours[cell].push_back(cell - 1);
+                if (i < nx - 1) neighbours[cell].push_back(cell + 1);
+                if (j > 0)      neighbours[cell].push_back(cell - nx);
+                if (j < ny - 1) neighbours[cell].push_back(cell + nx);
+            }
+        }
+        return neighbours;
+    }
+}
+
+BOOST_AUTO_TEST_CASE(SingleDomain)
+{
+    const auto neighbours = cartesianNeighbours(4, 3);
+    const auto [partition, num_domains] = Opm::partitionCellsBreadthFirst(neighbours, 1);
+
+    BOOST_CHECK_EQUAL(num_domains, 1);
+    for (const int domain : partition) {
+        BOOST_CHECK_EQUAL(domain, 0);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(AllCellsAssigned)
+{
+    const auto neighbours = cartesianNeighbours(10, 10);
+    const auto [partition, num_domains] = Opm::partitionCellsBreadthFirst(neighbours, 4);
+
+    BOOST_CHECK(num_domains >= 4);
+    std::vector<int> domain_size(num_domains, 0);
+    for (const int domain : partition) {
+        BOOST_REQUIRE(domain >= 0);
+        BOOST_REQUIRE(domain < num_domains);
+        ++domain_size[domain];
+    }
+    for (const int size : domain_size) {
+        BOOST_CHECK(size > 0);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(NeighbouringDomainsHaveDifferentColors)
+{
+    const auto neighbours = cartesianNeighbours(12, 7);
+    const auto [partition, num_domains] = Opm::partitionCellsBreadthFirst(neighbours, 6);
+    const auto [colors, num_colors] = Opm::colorDomains(neighbours, partition, num_domains);
+
+    BOOST_CHECK(num_colors >= 2);
+    BOOST_REQUIRE_EQUAL(colors.size(), static_cast<std::size_t>(num_domains));
+    for (std::size_t cell = 0; cell < neighbours.size(); ++cell) {
+        for (const int nb : neighbours[cell]) {
+            if (partition[nb] != partition[cell]) {
+                BOOST_CHECK(colors[partition[nb]] != colors[partition[cell]]);
+            }
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(InvalidNumberOfDomains)
+{
+    const auto neighbours = cartesianNeighbours(2, 2);
+    BOOST_CHECK_THROW(Opm::partitionCellsBreadthFirst(neighbours, 0), std::invalid_argument);
+}
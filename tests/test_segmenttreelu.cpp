@@ -0,0 +1,133 @@
+/*
+  Copyright 2021 Equinor ASA.
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <config.h>
+
+#define BOOST_TEST_MODULE SegmentTreeLUTest
+#include <boost/test/unit_test.hpp>
+
+#include <opm/simulators/wells/MSWellHelpers.hpp>
+
+#include <dune/common/fmatrix.hh>
+#include <dune/common/fvector.hh>
+#include <dune/istl/bcrsmatrix.hh>
+#include <dune/istl/bvector.hh>
+
+#include <vector>
+
+namespace {
+
+using Block = Dune::FieldMatrix<double, 2, 2>;
+using Matrix = Dune::BCRSMatrix<Block>;
+using Vector = Dune::BlockVector<Dune::FieldVector<double, 2>>;
+
+// Segment 0 is the top segment, segments 1 and 4 flow into 0 and
+// segments 2 and 3 flow into 1. The inlets are deliberately not
+// ordered after their outlets.
+const std::vector<std::vector<int>> inlets = { {1, 4}, {3, 2}, {}, {}, {} };
+const std::vector<int> outlets = { -1, 0, 1, 1, 0 };
+
+// The couplings of each segment to its inlets are taken from
+// patternInlets, which may differ from the tree given to factorize().
+Matrix buildMatrix(const std::vector<std::vector<int>>& patternInlets = inlets)
+{
+    const int num_seg = inlets.size();
+    Matrix D(num_seg, num_seg, Matrix::row_wise);
+    for (auto row = D.createbegin(); row != D.createend(); ++row) {
+        const int seg = row.index();
+        if (outlets[seg] >= 0) {
+            row.insert(outlets[seg]);
+        }
+        row.insert(seg);
+        for (const int inlet : patternInlets[seg]) {
+            row.insert(inlet);
+        }
+    }
+    for (auto row = D.begin(); row != D.end(); ++row) {
+        for (auto col = row->begin(); col != row->end(); ++col) {
+            const int i = row.index();
+            const int j = col.index();
+            if (i == j) {
+                *col = {{ 10.0 + i, 1.0 }, { -2.0, 8.0 + i }};
+            } else {
+                *col = {{ -1.0 - 0.1 * i, 0.5 }, { 0.3 * j, -2.0 }};
+            }
+        }
+    }
+    return D;
+}
+
+} // anonymous namespace
+
+BOOST_AUTO_TEST_CASE(SolveSegmentTree)
+{
+    const Matrix D = buildMatrix();
+    Opm::mswellhelpers::SegmentTreeLU<Matrix, Vector> lu;
+    BOOST_REQUIRE(lu.factorize(D, inlets));
+    BOOST_CHECK(lu.valid());
+
+    Vector rhs(D.N());
+    for (std::size_t i = 0; i < rhs.size(); ++i) {
+        rhs[i] = { 1.0 + i, 2.0 - 0.5 * i };
+    }
+
+    Vector x = rhs;
+    lu.solve(x);
+
+    Vector Dx(D.N());
+    D.mv(x, Dx);
+    for (std::size_t i = 0; i < rhs.size(); ++i) {
+        for (int k = 0; k < 2; ++k) {
+            BOOST_CHECK_CLOSE(Dx[i][k], rhs[i][k], 1e-10);
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(RejectPatternNotMatchingTree)
+{
+    const Matrix D = buildMatrix();
+    Opm::mswellhelpers::SegmentTreeLU<Matrix, Vector> lu;
+
+    // segment 2 listed as an inlet of two segments
+    const std::vector<std::vector<int>> twoOutlets = { {1, 4, 2}, {3, 2}, {}, {}, {} };
+    BOOST_CHECK(!lu.factorize(D, twoOutlets));
+    BOOST_CHECK(!lu.valid());
+
+    // the matrix has entries not in the given tree
+    const std::vector<std::vector<int>> missingInlet = { {1}, {3, 2}, {}, {}, {} };
+    BOOST_CHECK(!lu.factorize(D, missingInlet));
+}
+
+BOOST_AUTO_TEST_CASE(RejectSingularPivot)
+{
+    Matrix D = buildMatrix();
+    D[2][2] = 0.0;
+    Opm::mswellhelpers::SegmentTreeLU<Matrix, Vector> lu;
+    BOOST_CHECK(!lu.factorize(D, inlets));
+}
+
+BOOST_AUTO_TEST_CASE(RejectMissingInletCoupling)
+{
+    // Row 0 couples to segment 3 instead of its inlet 4, with the same
+    // number of entries as the tree requires.
+    const Matrix D = buildMatrix({ {1, 3}, {3, 2}, {}, {}, {} });
+    Opm::mswellhelpers::SegmentTreeLU<Matrix, Vector> lu;
+    BOOST_CHECK(!lu.factorize(D, inlets));
+    BOOST_CHECK(!lu.valid());
+}
@@ -0,0 +1,221 @@
+/*
+  Copyright 2021 Equinor ASA.
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <config.h>
+
+#define BOOST_TEST_MODULE TracerUpwindSolverTest
+#include <boost/test/unit_test.hpp>
+
+#include <ebos/ecltracerupwindsolver.hh>
+
+#include <dune/common/fmatrix.hh>
+#include <dune/common/fvector.hh>
+#include <dune/istl/bcrsmatrix.hh>
+#include <dune/istl/bvector.hh>
+#include <dune/istl/operators.hh>
+#include <dune/istl/preconditioners.hh>
+#include <dune/istl/solvers.hh>
+
+#include <set>
+#include <utility>
+#include <vector>
+
+namespace {
+
+using Solver = Opm::EclTracerUpwindSolver<double>;
+using Matrix = Dune::BCRSMatrix<Dune::FieldMatrix<double, 1, 1>>;
+using Vector = Dune::BlockVector<Dune::FieldVector<double, 1>>;
+
+// A small flow field with an acyclic part (cells 0-4), a circulating part
+// which is solved directly (cells 5-8) and a circulating part which is
+// larger than the direct solve limit and hence solved by Gauss-Seidel
+// (cells 9-108). The acyclic part is numbered against the flow direction,
+// i.e., a sweep in natural order would not be exact.
+struct System
+{
+    static constexpr unsigned numCells = 109;
+
+    std::vector<double> diag;
+    Solver::UpstreamList upstream;
+    std::vector<double> rhs;
+
+    System()
+        : diag(numCells, 0.0)
+        , upstream(numCells)
+        , rhs(numCells, 0.0)
+    {
+        for (unsigned I = 0; I < numCells; ++I) {
+            // storage term and accumulation of the last time step
+            diag[I] = 1.0 + 0.01*I;
+            rhs[I] = 0.5 + 0.002*((7*I) % 13);
+        }
+
+        // acyclic chain 4 -> 3 -> 2 -> 1 -> 0, plus a branch 4 -> 0
+        flux(4, 3, 2.0);
+        flux(3, 2, 2.0);
+        flux(2, 1, 1.5);
+        flux(1, 0, 1.5);
+        flux(4, 0, 0.5);
+
+        // small loop 0 -> 5 -> 6 -> 7 -> 8 -> 5 with an outlet 8 -> 9
+        flux(0, 5, 2.0);
+        flux(5, 6, 3.0);
+        flux(6, 7, 3.0);
+        flux(7, 8, 3.0);
+        flux(8, 5, 1.0);
+        flux(8, 9, 2.0);
+
+        // large loop 9 -> 10 -> ... -> 108 -> 9 with a counter flow
+        // between every other pair of cells
+        for (unsigned I = 9; I < numCells; ++I) {
+            const unsigned next = (I + 1 < numCells) ? I + 1 : 9;
+            flux(I, next, 4.0);
+            if (I % 2 == 0)
+                flux(next, I, 0.5);
+        }
+
+        // sources, e.g. injecting well connections
+        rhs[4] += 3.0;
+        rhs[60] += 1.0;
+    }
+
+    // a flux q from cell J to cell I: the outflow enters the diagonal of the
+    // upstream cell and the inflow couples the downstream cell to it.
+    void flux(unsigned J, unsigned I, double q)
+    {
+        diag[J] += q;
+        upstream[I].emplace_back(J, -q);
+    }
+
+    Matrix matrix() const
+    {
+        Matrix M(numCells, numCells, Matrix::random);
+        std::vector<std::set<unsigned>> pattern(numCells);
+        for (unsigned I = 0; I < numCells; ++I) {
+            pattern[I].insert(I);
+            for (const auto& up : upstream[I])
+                pattern[I].insert(up.first);
+        }
+        for (unsigned I = 0; I < numCells; ++I)
+            M.setrowsize(I, pattern[I].size());
+        M.endrowsizes();
+        for (unsigned I = 0; I < numCells; ++I)
+            for (unsigned J : pattern[I])
+                M.addindex(I, J);
+        M.endindices();
+
+        M = 0.0;
+        for (unsigned I = 0; I < numCells; ++I) {
+            M[I][I] = diag[I];
+            for (const auto& up : upstream[I])
+                M[I][up.first] += up.second;
+        }
+        return M;
+    }
+};
+
+// The Krylov solver which is used by the tracer model without the upwind
+// sweep, run to a tight tolerance.
+Vector referenceSolution(const System& sys)
+{
+    Matrix M = sys.matrix();
+    Vector b(System::numCells);
+    for (unsigned I = 0; I < System::numCells; ++I)
+        b[I] = sys.rhs[I];
+
+    Vector x(System::numCells);
+    x = 0.0;
+
+    using Operator = Dune::MatrixAdapter<Matrix, Vector, Vector>;
+    using ScalarProduct = Dune::SeqScalarProduct<Vector>;
+    using Preconditioner = Dune::SeqILU<Matrix, Vector, Vector>;
+
+    Operator op(M);
+    ScalarProduct sp;
+    Preconditioner prec(M, 0, 1); // results in ILU0
+    Dune::BiCGSTABSolver<Vector> solver(op, sp, prec, 1e-14, 1000, 0);
+
+    Dune::InverseOperatorResult result;
+    solver.apply(x, b, result);
+    BOOST_REQUIRE(result.converged);
+
+    return x;
+}
+
+} // anonymous namespace
+
+BOOST_AUTO_TEST_CASE(Ordering)
+{
+    System sys;
+    Solver solver;
+    solver.assemble(sys.diag, sys.upstream);
+
+    // one component for each cell of the acyclic part and one for each loop
+    BOOST_CHECK_EQUAL(solver.numComponents(), 5u + 1u + 1u);
+    BOOST_CHECK_EQUAL(solver.diagonal().size(), System::numCells);
+}
+
+BOOST_AUTO_TEST_CASE(MatchesKrylovSolution)
+{
+    System sys;
+    const Vector reference = referenceSolution(sys);
+
+    Solver solver;
+    solver.assemble(sys.diag, sys.upstream);
+
+    Vector c(System::numCells);
+    c = 0.0;
+    BOOST_CHECK(solver.solve(solver.diagonal(), sys.rhs, c));
+
+    for (unsigned I = 0; I < System::numCells; ++I)
+        BOOST_CHECK_CLOSE(c[I][0], reference[I][0], 1e-6);
+}
+
+BOOST_AUTO_TEST_CASE(DirectAndGaussSeidelAgree)
+{
+    System sys;
+
+    // the first solver treats all components directly, the second one uses
+    // Gauss-Seidel for all of them
+    Solver direct(System::numCells);
+    Solver gaussSeidel(1, 100, 1e-12);
+    direct.assemble(sys.diag, sys.upstream);
+    gaussSeidel.assemble(sys.diag, sys.upstream);
+
+    Vector cDirect(System::numCells);
+    Vector cGaussSeidel(System::numCells);
+    cDirect = 0.0;
+    cGaussSeidel = 0.0;
+    BOOST_CHECK(direct.solve(direct.diagonal(), sys.rhs, cDirect));
+    BOOST_CHECK(gaussSeidel.solve(gaussSeidel.diagonal(), sys.rhs, cGaussSeidel));
+
+    for (unsigned I = 0; I < System::numCells; ++I)
+        BOOST_CHECK_CLOSE(cDirect[I][0], cGaussSeidel[I][0], 1e-8);
+}
+
+BOOST_AUTO_TEST_CASE(ReportsGaussSeidelIterationLimit)
+{
+    System sys;
+    Solver solver(64, 1);
+    solver.assemble(sys.diag, sys.upstream);
+
+    Vector c(System::numCells);
+    c = 0.0;
+    BOOST_CHECK(!solver.solve(solver.diagonal(), sys.rhs, c));
+}
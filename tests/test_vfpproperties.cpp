@@ -23,6 +23,7 @@
 #define BOOST_TEST_MODULE VFPTest
 
 #include <algorithm>
+#include <array>
 #include <memory>
 #include <map>
 #include <sstream>
@@ -97,6 +98,22 @@ BOOST_AUTO_TEST_CASE(findInterpData)
     BOOST_CHECK_EQUAL(eval5.factor_, 1.0);
 }
 
+BOOST_AUTO_TEST_CASE(findInterpDataWithHint)
+{
+    std::vector<double> values = {1, 5, 7, 9, 11, 15};
+    const std::vector<double> points = {6.0, 6.5, 9.0, 0.5, 13.0, 19.0, 1.0};
+
+    int hint = -1;
+    for (const double point : points) {
+        const Opm::detail::InterpData expected = Opm::detail::findInterpData(point, values);
+        const Opm::detail::InterpData actual = Opm::detail::findInterpData(point, values, hint);
+        BOOST_CHECK_EQUAL(actual.ind_[0], expected.ind_[0]);
+        BOOST_CHECK_EQUAL(actual.ind_[1], expected.ind_[1]);
+        BOOST_CHECK_EQUAL(actual.factor_, expected.factor_);
+        BOOST_CHECK_EQUAL(hint, expected.ind_[0]);
+    }
+}
+
 BOOST_AUTO_TEST_SUITE_END() // HelperTests
 
 
@@ -551,6 +568,90 @@ BOOST_AUTO_TEST_CASE(THPToBHPAndBackNonTrivial)
 
 
 
+BOOST_AUTO_TEST_CASE(CachedBHPCurve)
+{
+    fillDataRandom();
+    initProperties();
+
+    Opm::detail::VFPProdCurveCache cache;
+    // the first two points are in the same cell of the table
+    const std::vector<std::array<double, 4>> points = {
+        {0.5, 0.3, 0.2, 32.9}, {0.55, 0.35, 0.25, 32.0}, {0.9, 0.1, 0.6, 5.0}
+    };
+    for (const auto& p : points) {
+        const std::vector<double>& curve = cache.curve(*table, p[0], p[1], p[2], p[3]);
+        BOOST_REQUIRE_EQUAL(curve.size(), flo_axis.size());
+
+        const auto thp_i = Opm::detail::findInterpData(p[0], table->getTHPAxis());
+        const auto wfr_i = Opm::detail::findInterpData(p[1], table->getWFRAxis());
+        const auto gfr_i = Opm::detail::findInterpData(p[2], table->getGFRAxis());
+        const auto alq_i = Opm::detail::findInterpData(p[3], table->getALQAxis());
+        for (std::size_t f = 0; f < flo_axis.size(); ++f) {
+            const auto flo_i = Opm::detail::findInterpData(flo_axis[f], flo_axis);
+            const double expected = Opm::detail::interpolate(*table, flo_i, thp_i, wfr_i, gfr_i, alq_i).value;
+            BOOST_CHECK_CLOSE(curve[f], expected, max_d_tol);
+        }
+    }
+}
+
+
+
+BOOST_AUTO_TEST_CASE(BatchedBHP)
+{
+    fillDataRandom();
+    initProperties();
+
+    const std::vector<double> aqua = {-0.5, -0.4, -0.1, -1.2, 0.0};
+    const std::vector<double> liquid = {-0.9, -1.0, -0.3, -0.2, -0.6};
+    const std::vector<double> vapour = {-0.1, -0.2, -0.8, -0.1, -0.3};
+    const std::vector<double> thp = {0.5, 0.5, 0.2, 0.9, 0.4};
+    const std::vector<double> alq = {32.9, 32.9, 10.0, 5.0, 20.0};
+
+    std::vector<double> bhp;
+    properties->bhp(1, aqua, liquid, vapour, thp, alq, bhp);
+
+    BOOST_REQUIRE_EQUAL(bhp.size(), aqua.size());
+    for (std::size_t i = 0; i < aqua.size(); ++i) {
+        const double expected = properties->bhp(1, aqua[i], liquid[i], vapour[i], thp[i], alq[i]);
+        BOOST_CHECK_CLOSE(bhp[i], expected, max_d_tol);
+    }
+}
+
+
+
+
+BOOST_AUTO_TEST_CASE(BHPDerivatives)
+{
+    fillDataRandom();
+    initProperties();
+
+    // inside a cell of the table, where the interpolant is smooth
+    const std::array<double, 3> rates = {-0.5, -0.9, -0.1};
+    const double thp = 0.4;
+    const double alq = 0.3;
+
+    std::array<double, 3> dbhp_drates;
+    double dbhp_dthp = 0.0;
+    const double bhp_val = properties->bhp(1, rates[0], rates[1], rates[2], thp, alq, dbhp_drates, dbhp_dthp);
+    BOOST_CHECK_CLOSE(bhp_val, properties->bhp(1, rates[0], rates[1], rates[2], thp, alq), max_d_tol);
+
+    const double h = 1.0e-6;
+    for (int i = 0; i < 3; ++i) {
+        auto plus = rates;
+        auto minus = rates;
+        plus[i] += h;
+        minus[i] -= h;
+        const double fd = (properties->bhp(1, plus[0], plus[1], plus[2], thp, alq)
+                           - properties->bhp(1, minus[0], minus[1], minus[2], thp, alq)) / (2.0*h);
+        BOOST_CHECK_CLOSE(dbhp_drates[i], fd, 1.0e-4);
+    }
+    const double fd_thp = (properties->bhp(1, rates[0], rates[1], rates[2], thp + h, alq)
+                           - properties->bhp(1, rates[0], rates[1], rates[2], thp - h, alq)) / (2.0*h);
+    BOOST_CHECK_CLOSE(dbhp_dthp, fd_thp, 1.0e-4);
+}
+
+
+
 
 BOOST_AUTO_TEST_SUITE_END() // Trivial tests
 
@@ -22,6 +22,8 @@
 #define BOOST_TEST_MODULE WellStateFIBOTest
 
 #include "MpiFixture.hpp"
+#include <opm/simulators/wells/GroupTree.hpp>
+#include <opm/simulators/wells/WellGroupHelpers.hpp>
 #include <opm/simulators/wells/WellStateFullyImplicitBlackoil.hpp>
 #include <opm/parser/eclipse/Python/Python.hpp>
 
@@ -39,6 +41,7 @@
 
 #include <opm/grid/GridManager.hpp>
 
+#include <algorithm>
 #include <chrono>
 #include <cstddef>
 #include <string>
@@ -377,6 +380,161 @@ BOOST_AUTO_TEST_CASE(Rates)
 
 // ---------------------------------------------------------------------
 
+BOOST_AUTO_TEST_CASE(CopyWellEntries)
+{
+    const Setup setup{ "msw.data" };
+    const auto tstep = std::size_t{0};
+
+    std::vector<Opm::ParallelWellInfo> pinfos;
+    auto wstate = buildWellState(setup, tstep, pinfos);
+
+    const auto wells = setup.sched.getWells(tstep);
+    setSegRates(wells, setup.pu, wstate);
+
+    const auto& inje = wstate.wellMap().at("INJE01");
+    const auto& prod = wstate.wellMap().at("PROD01");
+    const int inje_ix = inje[0];
+    const int prod_ix = prod[0];
+
+    auto scratch = wstate;
+    for (auto* ws : { &scratch.bhp(), &scratch.perfPress(), &scratch.segRates(), &scratch.segPress() }) {
+        std::fill(ws->begin(), ws->end(), -1.0);
+    }
+    scratch.currentProductionControls()[prod_ix] = Opm::Well::ProducerCMode::BHP;
+
+    scratch.copyWellEntries(wstate, prod_ix);
+
+    // the entries of PROD01 are restored
+    BOOST_CHECK_EQUAL(scratch.bhp()[prod_ix], wstate.bhp()[prod_ix]);
+    BOOST_CHECK(scratch.currentProductionControls()[prod_ix] == wstate.currentProductionControls()[prod_ix]);
+    for (int perf = prod[1]; perf < prod[1] + prod[2]; ++perf) {
+        BOOST_CHECK_EQUAL(scratch.perfPress()[perf], wstate.perfPress()[perf]);
+    }
+    const int np = wstate.numPhases();
+    const int top_seg = wstate.topSegmentIndex(prod_ix);
+    for (int seg = top_seg; seg < top_seg + 6; ++seg) {
+        BOOST_CHECK_EQUAL(scratch.segPress()[seg], wstate.segPress()[seg]);
+        for (int p = 0; p < np; ++p) {
+            BOOST_CHECK_EQUAL(scratch.segRates()[np*seg + p], wstate.segRates()[np*seg + p]);
+        }
+    }
+
+    // the entries of INJE01 are left alone
+    BOOST_CHECK_EQUAL(scratch.bhp()[inje_ix], -1.0);
+    for (int perf = inje[1]; perf < inje[1] + inje[2]; ++perf) {
+        BOOST_CHECK_EQUAL(scratch.perfPress()[perf], -1.0);
+    }
+    BOOST_CHECK_EQUAL(scratch.segPress()[wstate.topSegmentIndex(inje_ix)], -1.0);
+}
+
+// ---------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE(GroupData)
+{
+    const Setup setup{ "msw.data" };
+
+    std::vector<Opm::ParallelWellInfo> pinfos;
+    auto wstate = buildWellState(setup, 0, pinfos);
+
+    BOOST_CHECK(wstate.hasWellRates("PROD01"));
+    BOOST_CHECK(!wstate.hasWellRates("NO_SUCH_WELL"));
+
+    BOOST_CHECK(!wstate.hasProductionGroupRates("P"));
+    BOOST_CHECK_THROW(wstate.currentProductionGroupRates("P"), std::logic_error);
+
+    wstate.setCurrentProductionGroupRates("P", { 1.0, 2.0, 3.0 });
+    wstate.setCurrentProductionGroupRates("NEW_GROUP", { 4.0 });
+    BOOST_CHECK(wstate.hasProductionGroupRates("P"));
+    BOOST_CHECK_EQUAL(wstate.currentProductionGroupRates("P")[2], 3.0);
+    BOOST_CHECK_EQUAL(wstate.currentProductionGroupRates("NEW_GROUP")[0], 4.0);
+
+    // the injection controls of the different phases are independent
+    wstate.setCurrentInjectionGroupControl(Opm::Phase::GAS, "P", Opm::Group::InjectionCMode::RATE);
+    BOOST_CHECK(wstate.hasInjectionGroupControl(Opm::Phase::GAS, "P"));
+    BOOST_CHECK(!wstate.hasInjectionGroupControl(Opm::Phase::WATER, "P"));
+    BOOST_CHECK(wstate.currentInjectionGroupControl(Opm::Phase::GAS, "P") == Opm::Group::InjectionCMode::RATE);
+
+    // copies do not share the group data
+    auto copy = wstate;
+    copy.setCurrentProductionGroupRates("P", { 5.0, 6.0, 7.0 });
+    copy.setCurrentInjectionVREPRates("P", 8.0);
+    BOOST_CHECK_EQUAL(wstate.currentProductionGroupRates("P")[0], 1.0);
+    BOOST_CHECK_EQUAL(copy.currentProductionGroupRates("P")[0], 5.0);
+    BOOST_CHECK_THROW(wstate.currentInjectionVREPRates("P"), std::logic_error);
+    BOOST_CHECK_EQUAL(copy.currentInjectionVREPRates("P"), 8.0);
+}
+
+// ---------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE(Snapshot)
+{
+    const Setup setup{ "msw.data" };
+
+    std::vector<Opm::ParallelWellInfo> pinfos;
+    auto wstate = buildWellState(setup, 0, pinfos);
+
+    // the well map is shared by the snapshot
+    auto snapshot = wstate;
+    BOOST_CHECK(&snapshot.wellMap() == &wstate.wellMap());
+
+    wstate.bhp()[0] = 123.0;
+    wstate.setCurrentProductionGroupRates("NEW_GROUP", { 1.0 });
+    BOOST_CHECK(snapshot.bhp()[0] != 123.0);
+    BOOST_CHECK(!snapshot.hasProductionGroupRates("NEW_GROUP"));
+
+    snapshot = wstate;
+    BOOST_CHECK_EQUAL(snapshot.bhp()[0], 123.0);
+    BOOST_CHECK_EQUAL(snapshot.currentProductionGroupRates("NEW_GROUP")[0], 1.0);
+}
+
+// ---------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE(GroupHierarchy)
+{
+    const Setup setup{ "msw.data" };
+
+    std::vector<Opm::ParallelWellInfo> pinfos;
+    auto wstate = buildWellState(setup, 0, pinfos);
+
+    auto tree = Opm::GroupTree{ setup.sched, 0 };
+    tree.resolveStateIndices(wstate);
+    BOOST_CHECK_EQUAL(tree.numGroups(), 3);
+    BOOST_CHECK_EQUAL(tree.groupName(0), "FIELD");
+    BOOST_CHECK_EQUAL(tree.parent(0), -1);
+    BOOST_CHECK_EQUAL(tree.parent(tree.groupIndex("I")), 0);
+    BOOST_CHECK_EQUAL(tree.parent(tree.groupIndex("P")), 0);
+    BOOST_CHECK_EQUAL(tree.groupIndex("NO_SUCH_GROUP"), -1);
+    BOOST_CHECK_EQUAL(tree.accumulatedEfficiencyFactor("P"), 1.0);
+    BOOST_CHECK_THROW(tree.accumulatedEfficiencyFactor("NO_SUCH_GROUP"), std::logic_error);
+    BOOST_CHECK_EQUAL(tree.wells().size(), 2U);
+
+    // the indices in the well state are resolved once, by name
+    for (int group = 0; group < tree.numGroups(); ++group) {
+        BOOST_CHECK_EQUAL(tree.groupStateIndex(group), wstate.groupIndex(tree.groupName(group)));
+    }
+    for (const auto& well : tree.wells()) {
+        BOOST_CHECK_EQUAL(well.state_index, wstate.wellNameIndex(well.name));
+        BOOST_CHECK_EQUAL(well.local_index, wstate.wellMap().at(well.name)[0]);
+        BOOST_CHECK(well.owned);
+    }
+
+    // the group rates are the sums over the tree, with positive production
+    const int np = wstate.numPhases();
+    const int prod_ix = wstate.wellMap().at("PROD01")[0];
+    for (int p = 0; p < np; ++p) {
+        wstate.wellRates()[prod_ix*np + p] = -(p + 1.0);
+    }
+
+    Opm::WellGroupHelpers::updateGroupProductionRates(tree, wstate, wstate);
+    for (int p = 0; p < np; ++p) {
+        BOOST_CHECK_EQUAL(wstate.currentProductionGroupRates("P")[p], p + 1.0);
+        BOOST_CHECK_EQUAL(wstate.currentProductionGroupRates("FIELD")[p], p + 1.0);
+        BOOST_CHECK_EQUAL(wstate.currentProductionGroupRates("I")[p], 0.0);
+    }
+}
+
+// ---------------------------------------------------------------------
+
 BOOST_AUTO_TEST_CASE(STOP_well)
 {
     /*